@@ -24,56 +24,495 @@
  */
 
 //////////////////////////////////////////////// INCLUDES ////////////////////////////////////////////////////////////////////////
+#define _POSIX_C_SOURCE 200809L // strnlen, posix_madvise (also under -std=c11)
 #include <time.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+
+// users.dat and reservations.dat are mapped into memory to load them (plain read of the whole file elsewhere)
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// SSE2/AVX2 kernels for the columnar reservation store, chosen at runtime (scalar code everywhere else)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_SIMD 1
+#include <immintrin.h>
+#endif
 //////////////////////////////////////////////// STRUCTS ////////////////////////////////////////////////////////////////////////
 
 // Structs
+
+// Id of an interned string (see internString), 0 = none; equal strings have equal symbols
+typedef uint32_t Symbol;
+
+#define CITY_NAME_MAX 50
+#define LOCATION_MAX 100
+
 typedef struct User {
     char username[50];
     char password[50];
     int isAdmin;
+    int userID;         // Persistent and never reused, position in userSlots
     struct User *next;  // Pointer to the next user in the list
+    struct User *prev;  // Lets deleteUser unlink without walking the list
 } User;
 
+// Start of users.dat and reservations.dat; the records follow right after it (20 bytes, keeps them int-aligned)
+typedef struct FileHeader {
+    char magic[4];        // USERS_FILE_MAGIC or RESERVATIONS_FILE_MAGIC
+    uint16_t version;     // FILE_FORMAT_VERSION of the program that wrote it
+    uint16_t recordSize;  // sizeof the record struct, a mismatch means another layout
+    uint32_t recordCount;
+    uint32_t extra;       // users.dat: next free user id; reservations.dat: first log segment not in the file
+    uint32_t checksum;    // CRC-32 of the records, continued over the header fields above
+} FileHeader;
+
+#define FILE_FORMAT_VERSION 1
+
+// Result of checkFileHeader
+typedef enum HeaderCheck {
+    HEADER_OK,
+    HEADER_MISSING,  // Older layout without the header, read from the start of the file
+    HEADER_REJECTED  // Damaged, truncated or written by a newer version
+} HeaderCheck;
+
+// A user as stored in users.dat, after the FileHeader
+typedef struct UserRecord {
+    int userID;
+    char username[50];
+    char password[50];
+    int isAdmin;
+} UserRecord;
+
+// Files written before user ids start straight with a record (104 bytes, no id)
+typedef struct LegacyUserRecord {
+    char username[50];
+    char password[50];
+    int isAdmin;
+} LegacyUserRecord;
+
+#define USERS_FILE_MAGIC "USER"
+#define USERS_FILE_MAGIC_V2 "USR2" // Tag and next free id, then the records, no header
+
+// Dense id -> User table; a deleted user leaves a NULL (tombstone) and its id is not handed out again
+typedef struct UserSlots {
+    User **slots;
+    int capacity;
+    int nextID;
+} UserSlots;
+
 typedef struct Flight {
     int flightNumber;
-    char origin[50];
-    char destination[50];
+    Symbol origin;      // Interned city names, symbolName() gives the text
+    Symbol destination;
     char departureTime[20];
     char arrivalTime[20];
     int seatsAvailable;
+    int departureMinutes; // Parsed from departureTime (minutes since midnight), -1 if it is not a valid HH:MM
+    int arrivalMinutes;   // Same for arrivalTime; the strings are kept for display and flights.txt
+    int departureSlot;    // Position in departureIndex, so removing a flight does not search the whole catalog
     struct Flight *next;
+    struct Flight *prev; // Lets deleteFlight unlink without walking the list
 } Flight;
 
 typedef struct Hotel {
     int hotelID;
     char name[50];
-    char location[100];
+    Symbol location;    // Interned like the flight cities
     int roomsAvailable;
     struct Hotel *next;
+    struct Hotel *prev; // Lets deleteHotel unlink without walking the list
 } Hotel;
 
+// Reservation life cycle, see statusTransitions for the allowed moves
+// RES_ prefix: <windows.h> defines STATUS_PENDING and others as macros
+typedef enum ReservationStatus {
+    RES_PENDING,
+    RES_APPROVED,
+    RES_REJECTED,
+    RES_CANCEL_REQUESTED,
+    RES_CANCELLED,
+    RES_COUNT
+} ReservationStatus;
+
 typedef struct Reservation {
     int reservationID;
-    char username[50]; // Linking to the user who made the reservation
+    Symbol user; // Interned username of who made the reservation
     int flightNumber; // For flight reservations; -1 if not applicable
     int hotelID; // For hotel reservations; -1 if not applicable
-    char status[30]; // "Pending", "Approved", "Rejected", "Cancelled", "Cancel Requested"
+    unsigned char status; // ReservationStatus
+    int startDay; // Flight: travel day; hotel: check-in day (days since 1970-01-01), NO_DATE if made before dates existed
+    int endDay;   // Day after the last one held: travel day + 1 for a flight, check-out day for a hotel
     struct Reservation *next;
+    // In-memory links only
+    struct Reservation *nextForUser;
+    struct Reservation *prevInStatus; // Links in statusQueues[status]
+    struct Reservation *nextInStatus;
 } Reservation;
 
+// A reservation as stored in reservations.dat, with the username written out in full
+typedef struct ReservationRecord {
+    int reservationID;
+    char username[50];
+    unsigned char status; // ReservationStatus, one byte so it fits in the padding after username
+    int flightNumber;
+    int hotelID;
+    int startDay;
+    int endDay;
+} ReservationRecord;
+
+#define RESERVATION_RECORD_SIZE sizeof(ReservationRecord)
+
+// Files written before the status enum start straight with a record, newer ones with a tag (now the FileHeader)
+#define RESERVATIONS_FILE_MAGIC "RESV"
+#define RESERVATIONS_FILE_MAGIC_V4 "RSV4" // Followed by the first log segment not contained in the file, then the records
+#define RESERVATIONS_FILE_MAGIC_V3 "RSV3" // Same records, no log segment
+#define RESERVATIONS_FILE_MAGIC_V2 "RSV2" // Same record without the travel dates
+
+// Record layout of "RSV2" files (64 bytes per reservation)
+typedef struct ReservationRecordV2 {
+    int reservationID;
+    char username[50];
+    unsigned char status;
+    int flightNumber;
+    int hotelID;
+} ReservationRecordV2;
+
+// Record layout of reservations.dat before the status enum (96 bytes per reservation)
+typedef struct LegacyReservationRecord {
+    int reservationID;
+    char username[50];
+    int flightNumber;
+    int hotelID;
+    char status[30];
+} LegacyReservationRecord;
+
+// Reservation changes are appended to numbered log segments (reservations.log.1, .2, ...) instead of rewriting reservations.dat
+#define RESERVATION_LOG_PREFIX "reservations.log"
+#define CHECKPOINT_LOG_BYTES (64 * 1024) // A segment this big is folded into reservations.dat (about 800 changes)
+
+typedef enum ReservationLogType {
+    LOG_CREATE = 1, // A new reservation, every field filled
+    LOG_STATUS = 2  // Status change, only reservationID and status are used
+} ReservationLogType;
+
+// One event in reservations.log (80 bytes); fixed size so a torn write at the end is easy to spot
+typedef struct ReservationLogRecord {
+    uint32_t checksum; // CRC-32 of everything after this field
+    unsigned char type; // ReservationLogType
+    unsigned char status;
+    int reservationID;
+    int flightNumber;
+    int hotelID;
+    int startDay;
+    int endDay;
+    char username[50];
+} ReservationLogRecord;
+
+typedef struct ReservationLog {
+    FILE *file;             // Current segment, opened for append on the first logged change
+    unsigned firstSegment;  // Oldest segment not yet contained in reservations.dat
+    unsigned segment;       // Segment new changes are appended to
+    long bytes;             // Size of the current segment
+} ReservationLog;
+
+// Per-user view of the reservation list, same order as reservationsHead
+typedef struct UserReservations {
+    Symbol user;
+    Reservation *head;
+    Reservation *tail;
+} UserReservations;
+
+// Reservations currently in one status, oldest submission at the head
+typedef struct StatusQueue {
+    Reservation *head;
+    Reservation *tail;
+    int count;
+} StatusQueue;
+
+// Live reservation counts for one flight or hotel, kept up to date by setReservationStatus
+// Travel dates are day numbers (days since 1970-01-01) so a date compare or a night count is integer math
+#define NO_DATE -1
+#define BOOKING_HORIZON_DAYS 730 // How far ahead a reservation can be made
+#define CLOSED_HISTORY_DAYS 90   // Rejected/cancelled reservations stay in the history this long after their last day
+#define MAX_STAY_NIGHTS 60
+
+typedef struct Occupancy {
+    int undated;  // Pending/approved reservations without dates, they hold a seat or room on every day
+    int firstDay; // Day number of booked[0]
+    int dayCount;
+    int *booked;  // Dated pending/approved reservations holding each day, grown to cover the days booked so far
+} Occupancy;
+
+// Open addressing (linear probing) hash index from an int key to a record pointer
+typedef struct IntIndex {
+    int *keys;
+    void **values;    // NULL = empty slot, INDEX_TOMBSTONE = deleted entry
+    size_t capacity;  // Always a power of two (or 0 before the first insert)
+    size_t count;     // Live entries
+    size_t used;      // Live entries + tombstones, drives the resize
+} IntIndex;
+
+// Same scheme keyed by string; keys point into the indexed record, they are not copied
+typedef struct StrIndex {
+    const char **keys;
+    unsigned int *hashes; // Cached so probing and resizing skip most strcmp calls
+    void **values;        // NULL = empty slot, INDEX_TOMBSTONE = deleted entry
+    size_t capacity;
+    size_t count;
+    size_t used;
+} StrIndex;
+
+#define SYMBOL_BLOCK_SIZE 65536
+
+typedef struct SymbolBlock {
+    struct SymbolBlock *next;
+    size_t used;
+    size_t capacity;
+    char text[];
+} SymbolBlock;
+
+// Every distinct username and city name stored once; records keep the 32-bit Symbol instead of a copy
+typedef struct SymbolTable {
+    const char **names;   // names[symbol], names[0] = ""
+    uint32_t count;
+    uint32_t capacity;
+    StrIndex lookup;      // text -> symbol
+    SymbolBlock *blocks;  // Text storage, never moves so names and lookup keys stay valid
+} SymbolTable;
+
+// Flights sharing one key (a route, an origin or a destination), sorted by departure time when "sorted" is set
+typedef struct FlightBucket {
+    char *key;
+    Flight **flights;
+    int count;
+    int capacity;
+    bool sorted;     // Appends clear it, queries sort again on demand (bulk loads sort once)
+} FlightBucket;
+
+// hotelIDs of the hotels whose name or location contains one token, sorted when "sorted" is set
+typedef struct PostingList {
+    char *token;
+    int *hotelIDs;
+    int count;
+    int capacity;
+    bool sorted;     // Out-of-order appends clear it, removals and queries sort again on demand (bulk loads sort once)
+} PostingList;
+
+#define AUTOCOMPLETE_TOP_K 5
+
+// One distinct city of the catalogs; weight = how many flights/hotels mention it
+typedef struct CityEntry {
+    char *display;
+    char *key;   // Folded (foldText), what the trie is built on
+    int weight;
+} CityEntry;
+
+// Radix trie node; its subtree is the contiguous range of cities (sorted by key) sharing its prefix
+typedef struct TrieNode {
+    int city;        // Edge label is cities[city].key[labelStart .. labelStart + labelLength)
+    int labelStart;
+    int labelLength;
+    int firstChild;  // Children are stored next to each other in nodes
+    int childCount;
+    int top[AUTOCOMPLETE_TOP_K]; // Heaviest cities of the subtree, precomputed so a query stops at the prefix
+    int topCount;
+} TrieNode;
+
+typedef struct CityTrie {
+    CityEntry *cities;
+    int cityCount;
+    TrieNode *nodes;
+    int nodeCount;
+    bool dirty;      // Set by every catalog change, the trie is rebuilt on the next query
+} CityTrie;
+
+typedef enum FuzzyKind {
+    FUZZY_CITY,
+    FUZZY_HOTEL
+} FuzzyKind;
+
+// A city or hotel name as the fuzzy search sees it
+typedef struct FuzzyEntry {
+    FuzzyKind kind;
+    const char *display;  // Points into the trie city or the hotel
+    char *key;            // Folded once when the index is built
+    int hotelID;          // FUZZY_HOTEL only
+    int trigramCount;     // Distinct trigrams of the key
+} FuzzyEntry;
+
+typedef struct TrigramPostings {
+    int *entries;
+    int count;
+    int capacity;
+} TrigramPostings;
+
+// Trigram -> entries containing it; rebuilt together with the city trie
+typedef struct TrigramIndex {
+    FuzzyEntry *entries;
+    int entryCount;
+    TrigramPostings *lists;
+    int listCount;
+    IntIndex listIds;     // Packed trigram -> list id + 1
+    int *shared;          // Query scratch: trigrams in common per entry, reset through touched
+    int *touched;
+} TrigramIndex;
+
+typedef struct FuzzyMatch {
+    const FuzzyEntry *entry;
+    int score;            // Percent of trigrams in common (Jaccard)
+} FuzzyMatch;
+
+// Airports as nodes and flights as edges, adjacency in CSR form: flights leaving airport a are edges[edgeStart[a] .. edgeStart[a + 1])
+typedef struct FlightGraph {
+    int airportCount;
+    char **airports;      // Folded name of each airport id
+    StrIndex airportIds;  // name -> airport id + 1
+    int *edgeStart;
+    Flight **edges;
+    int *edgeTarget;      // Destination airport id of each edge
+    bool dirty;           // Set by every catalog change, rebuilt before the next connection search
+} FlightGraph;
+
+#define CONNECTION_MAX_LEGS 3
+#define MIN_CONNECTION_MINUTES 60
+#define MINUTES_PER_DAY 1440
+
+// One flight of an itinerary; times are minutes counted from 00:00 of the day the search starts
+typedef struct ItineraryLeg {
+    Flight *flight;
+    int departAt;
+    int arriveAt;
+} ItineraryLeg;
+
+typedef struct Itinerary {
+    ItineraryLeg legs[CONNECTION_MAX_LEGS];
+    int legCount;
+    int arriveAt;
+} Itinerary;
+
+#define ARENA_FIRST_SLAB 256
+#define ARENA_MAX_SLAB 65536
+
+typedef struct ArenaSlab {
+    struct ArenaSlab *next;
+    size_t used;      // Records handed out
+    size_t capacity;  // Records that fit
+    _Alignas(max_align_t) unsigned char records[];
+} ArenaSlab;
+
+// Records of one type packed in slabs, in allocation (load) order. Nothing goes back to malloc one record at a time:
+// the whole generation is freed at once with arenaFreeAll, a deleted user, flight or hotel stays in its slab until then
+typedef struct Arena {
+    size_t recordSize;
+    ArenaSlab *slabs; // Newest first, allocation happens in the first one
+} Arena;
+
+// Fixed-size pool for Reservation nodes: released nodes (closed reservations purged from the history) are kept on a
+// free list and reused first, the arena is only asked when the list is empty. Not shared, each session thread gets its own pool once sessions run concurrently
+typedef struct ReservationPool {
+    Arena *arena;
+    Reservation *freeList;  // Linked through next
+    size_t freeCount;
+    size_t hits;            // Acquires served by the free list
+    size_t misses;          // Acquires that went to the arena
+    size_t releases;
+} ReservationPool;
+
+// Read-only view of a whole binary file; records are decoded straight from data, with no copy into a read buffer
+typedef struct MappedFile {
+    const unsigned char *data;
+    size_t size;
+    size_t offset; // Next record, advanced by mappedNext
+#if defined(_WIN32)
+    HANDLE mapping;
+#endif
+} MappedFile;
+
+#define LINE_READER_BLOCK (1 << 20) // flights.txt / hotels.txt are read 1 MB at a time
+
+// Buffered line splitter for the text files; lines are handed out in place, terminated with '\0'
+typedef struct LineReader {
+    FILE *file;
+    char *buffer;
+    size_t capacity; // Grows only when a single line does not fit
+    size_t start;    // Unread bytes are buffer[start .. end)
+    size_t end;
+    long lineNumber; // Of the line returned last, for error messages
+    bool atEnd;
+} LineReader;
+
+// Column-oriented copy of a reservation list, one array per field so a scan only touches the columns it needs
+typedef struct ReservationColumns {
+    int *reservationIDs;
+    int *flightNumbers;
+    int *hotelIDs;
+    unsigned char *statuses;
+    int *users;          // Symbol of the username
+    size_t count;
+    size_t capacity;
+} ReservationColumns;
+
 /////////////////////////////////////////////////// GLOBAL VARIABLES  /////////////////////////////////////////////////////////////////////
 
+const char *statusNames[RES_COUNT] = {"Pending", "Approved", "Rejected", "Cancel Requested", "Cancelled"};
+
+// statusTransitions[from][to]: Pending -> Approved/Rejected, Approved -> Cancel Requested -> Cancelled/Approved
+const bool statusTransitions[RES_COUNT][RES_COUNT] = {
+        [RES_PENDING]          = {[RES_APPROVED] = true, [RES_REJECTED] = true},
+        [RES_APPROVED]         = {[RES_CANCEL_REQUESTED] = true},
+        [RES_CANCEL_REQUESTED] = {[RES_CANCELLED] = true, [RES_APPROVED] = true},
+};
+
 
 User *head = NULL;
+User *usersTail = NULL; // registerUser appends here instead of walking to the end
+UserSlots userSlots = {.nextID = 1};
 Flight *flightsHead = NULL;
 Hotel *hotelsHead = NULL;
 Reservation *reservationsHead = NULL;
 
+// Every User/Flight/Hotel/Reservation record lives in its arena
+Arena userArena = {.recordSize = sizeof(User)};
+Arena flightArena = {.recordSize = sizeof(Flight)};
+Arena hotelArena = {.recordSize = sizeof(Hotel)};
+Arena reservationArena = {.recordSize = sizeof(Reservation)};
+ReservationPool reservationPool = {.arena = &reservationArena}; // Bookings take their nodes from here
+ReservationLog reservationLog = {NULL, 1, 1, 0};
+
+IntIndex flightIndex = {0}; // flightNumber -> Flight*
+IntIndex hotelIndex = {0};  // hotelID -> Hotel*
+StrIndex userIndex = {0};   // username -> User*
+IntIndex reservationIndex = {0}; // reservationID -> Reservation*
+IntIndex userReservationsIndex = {0}; // username symbol -> UserReservations*
+SymbolTable symbols = {0};
+IntIndex flightOccupancy = {0}; // flightNumber -> Occupancy*
+IntIndex hotelOccupancy = {0};  // hotelID -> Occupancy*
+StatusQueue statusQueues[RES_COUNT] = {{0}};
+StrIndex routeIndex = {0};       // "origin|destination" -> FlightBucket*
+StrIndex originIndex = {0};      // origin -> FlightBucket*
+StrIndex destinationIndex = {0}; // destination -> FlightBucket*
+FlightBucket departureIndex = {0}; // Every flight, sorted by departure time
+StrIndex hotelTokenIndex = {0};  // normalized token -> PostingList*
+CityTrie cityTrie = {.dirty = true};
+FlightGraph flightGraph = {.dirty = true};
+TrigramIndex nameTrigrams = {0};
+
 char currentUser[50] = {0};
 
 
@@ -121,6 +560,29 @@ void deleteFlight();
 void editFlight();
 void listFlights();
 bool flightExists(int flightNumber);
+void printFlightAvailability(const Flight *flight);
+
+// Flight search
+void searchFlights();
+const FlightBucket *findFlightsOnRoute(const char *origin, const char *destination);
+int findFlightsByDeparture(const char *origin, const char *destination, int fromMinutes, int toMinutes, Flight ***first);
+int parseTimeOfDay(const char *text);
+void parseFlightTimes(Flight *flight);
+void routeIndexAdd(Flight *flight);
+void routeIndexRemove(Flight *flight);
+
+// Connection search
+void buildFlightGraph();
+int findConnections(const char *origin, const char *destination, int maxLegs, int minConnection, int startMinutes, Itinerary *results);
+
+// Text folding and fuzzy search
+size_t foldText(const char *text, char *out, size_t size);
+int fuzzySearchNames(const char *query, FuzzyKind kind, FuzzyMatch *results, int maxResults);
+
+// City autocomplete
+int autocompleteCity(const char *prefix, const char **results, int maxResults);
+void buildCityTrie();
+void freeCityTrie();
 
 // Hotel Handling
 void manageHotels();
@@ -129,6 +591,13 @@ void deleteHotel();
 void editHotel();
 void listHotels();
 bool hotelExists(int hotelID);
+void printHotelAvailability(const Hotel *hotel);
+
+// Hotel search
+void searchHotels();
+int *findHotelsByKeywords(const char *query, int *count);
+void hotelTokenIndexAdd(const Hotel *hotel);
+void hotelTokenIndexRemove(const Hotel *hotel);
 
 // Reservation Handling
 void makeFlightReservation(const char *username);
@@ -140,9 +609,18 @@ void handleCancellationRequests(); // Admin function to handle cancellation requ
 void viewAllReservations();
 void saveReservationsToFile();
 void loadReservationsFromFile();
+void addReservation(Reservation *reservation);
+
+// Reservation log
+uint32_t computeCrc32(uint32_t crc, const void *data, size_t length);
+void logReservationCreated(const Reservation *reservation);
+void logReservationStatus(const Reservation *reservation);
+bool replayReservationLog();
+void setAsideReservationLog();
+void closeReservationLog();
 
 // LIST RESERVAS
-void listReservationsByStatus(const char *status);
+void listReservationsByStatus(ReservationStatus status);
 void viewPendingReservations();
 void viewRequestCanceledReservations();
 void viewAcceptedReservations(); // NAO USADO
@@ -151,18 +629,84 @@ void viewCanceledReservations(); // NAO USADO
 // AMBAS APENAS PARA O LIST DO USER VER SE HA LUGARES
 void listFlightsUser();
 void listHotelsUser();
-int countReservationsByFlight(int flightNumber, const char* status);
-int countReservationsByHotel(int hotelID, const char* status);
-int calculateAvailableSeats(int flightNumber);
-int calculateAvailableRooms(int hotelID);
-
-
-
+int calculateAvailableSeats(int flightNumber, int day);
+int calculateAvailableRooms(int hotelID, int checkIn, int checkOut);
+
+// Travel dates
+int daysFromCivil(int year, int month, int day);
+int parseDate(const char *text);
+void formatDate(int day, char *out, size_t size);
+int currentDay();
+void formatReservationDates(const Reservation *reservation, char *out, size_t size);
+
+
+
+
+// Hash indexes
+void *intIndexFind(const IntIndex *index, int key);
+bool intIndexInsert(IntIndex *index, int key, void *value);
+void intIndexRemove(IntIndex *index, int key);
+void intIndexClear(IntIndex *index);
+Flight *findFlight(int flightNumber);
+Hotel *findHotel(int hotelID);
+void *strIndexFind(const StrIndex *index, const char *key);
+bool strIndexInsert(StrIndex *index, const char *key, void *value);
+void strIndexRemove(StrIndex *index, const char *key);
+void strIndexClear(StrIndex *index);
+User *findUser(const char *username);
+User *findUserByID(int userID);
+bool assignUserSlot(User *user);
+Reservation *findReservation(int reservationID);
+UserReservations *getUserReservations(Symbol user, bool create);
+Symbol internString(const char *text);
+Symbol findSymbol(const char *text);
+const char *symbolName(Symbol symbol);
+void linkUserReservation(Reservation *reservation, bool atHead);
+int purgeClosedReservations();
+Occupancy *getOccupancy(IntIndex *index, int key, bool create);
+void adjustOccupancy(const Reservation *reservation, int delta);
+int bookedOnDay(const Occupancy *occupancy, int day);
+bool reservationColumnsAppend(ReservationColumns *columns, const Reservation *reservation);
+bool reservationColumnsBuild(ReservationColumns *columns, const Reservation *list);
+void reservationColumnsFree(ReservationColumns *columns);
+size_t reservationColumnsCountFlight(const ReservationColumns *columns, int flightNumber, ReservationStatus status);
+size_t reservationColumnsCountHotel(const ReservationColumns *columns, int hotelID, ReservationStatus status);
+size_t reservationColumnsFilterUser(const ReservationColumns *columns, const char *username, int *rows);
+void benchmarkReservationStores();
+void statusQueuePush(Reservation *reservation, bool atHead);
+void statusQueueRemove(Reservation *reservation);
+bool canChangeStatus(const Reservation *reservation, ReservationStatus status);
+bool setReservationStatus(Reservation *reservation, ReservationStatus status);
+int parseReservationStatus(const char *name);
+
+// Record arenas
+bool arenaReserve(Arena *arena, size_t records);
+void *arenaAlloc(Arena *arena);
+void arenaUnalloc(Arena *arena);
+void arenaFreeAll(Arena *arena);
+void freeAllRecords();
+Reservation *reservationPoolAcquire(ReservationPool *pool);
+void reservationPoolRelease(ReservationPool *pool, Reservation *reservation);
+void printReservationPoolStats(const char *label, const ReservationPool *pool);
+void benchmarkReservationPool();
+
+// Text file parsing
+bool lineReaderOpen(LineReader *reader, const char *path);
+char *lineReaderNext(LineReader *reader, size_t *length);
+void lineReaderClose(LineReader *reader);
+int splitFields(char *line, size_t length, char **fields, int maxFields);
+bool parseIntField(const char *text, int *value);
+
+// Mapped files
+bool mapFile(const char *path, MappedFile *file);
+const void *mappedNext(MappedFile *file, size_t size);
+void unmapFile(MappedFile *file);
 
 // Declaration of functions to handle reservation IDs
 int loadLastReservationID();
 void saveLastReservationID(int lastID);
 int generateReservationID();
+void advanceReservationID(int reservationID);
 
 void generateReservationsReport();
 
@@ -177,6 +721,7 @@ int main() {
     loadHotelsFromFile();
     loadReservationsFromFile();
     loadLastReservationID();
+    buildCityTrie(); // Folded city/hotel keys and their trigrams are computed once here, not per query
     // LOAD DONE
     mainMenu();
     return 0;
@@ -221,9 +766,16 @@ void mainMenu() {
                 saveUsers();
                 saveFlightsToFile();
                 saveHotelsToFile();
-                saveReservationsToFile();
+                closeReservationLog(); // Reservations are already on disk, every change was logged
                 saveLastReservationID(generateReservationID(1));
+                freeAllRecords();
                 exit(0);
+            case 6: //hiden case DEBUG
+                benchmarkReservationStores();
+                break;
+            case 7: //hiden case DEBUG
+                benchmarkReservationPool();
+                break;
             case 5: //hiden case DEBUG
                 printAllUsersWithPasswords();
             default:
@@ -277,7 +829,6 @@ void adminMenu() {
                 generateReservationsReport();
                 break;
             case 8:
-                saveReservationsToFile();
                 return;
             default:
                 printf("Invalid choice, please try again.\n");
@@ -305,10 +856,10 @@ void userMenu() {
 
         switch (choice) {
             case 1:
-                listFlights();
+                searchFlights();
                 break;
             case 2:
-                listHotels();
+                searchHotels();
                 break;
             case 3:
                 listFlightsUser();
@@ -331,7 +882,6 @@ void userMenu() {
                 break;
             case 7:
                 logout();
-                saveReservationsToFile();
                 return;
             default:
                 printf("Invalid choice, please try again.\n");
@@ -438,12 +988,10 @@ void manageFlights() {
 
 void listUsersWithID() {
     User *current = head;
-    int id = 1;  // Start ID from user 1
     printf("\nUsers currently registered in system:\n");
     while (current != NULL) {
-        printf("ID: %d, User: %s, Admin: %s\n", id, current->username, current->isAdmin ? "Yes" : "No");
+        printf("ID: %d, User: %s, Admin: %s\n", current->userID, current->username, current->isAdmin ? "Yes" : "No");
         current = current->next;
-        id++;  // Increment ID for the next
     }
 }
 
@@ -453,28 +1001,26 @@ void deleteUser() {
     scanf("%d", &id);
     clearInputBuffer();
 
-    User *current = head;
-    User *previous = NULL;
-    int currentId = 1;
-
-    while (current != NULL) {
-        if (currentId == id) {
-            if (previous == NULL) {
-                head = current->next;
-            } else {
-                previous->next = current->next;
-            }
-            free(current);
-            printf("User deleted successfully.\n");
-            saveUsers();
-            return;
-        }
-        previous = current;
-        current = current->next;
-        currentId++;
+    User *current = findUserByID(id);
+    if (current == NULL) {
+        printf("User with ID %d not found.\n", id);
+        return;
     }
 
-    printf("User with ID %d not found.\n", id);
+    if (current->prev == NULL) {
+        head = current->next;
+    } else {
+        current->prev->next = current->next;
+    }
+    if (current->next == NULL) {
+        usersTail = current->prev;
+    } else {
+        current->next->prev = current->prev;
+    }
+    userSlots.slots[id] = NULL; // Tombstone, the ids of the other users do not move
+    strIndexRemove(&userIndex, current->username);
+    printf("User deleted successfully.\n");
+    saveUsers();
 }
 ////////////////////////////////////////// HOTEL HANDLING //////////////////////////////////////////////////////////////////////////////
 
@@ -489,7 +1035,7 @@ void addHotel() {
         return;
     }
 
-    Hotel *newHotel = (Hotel *)malloc(sizeof(Hotel));
+    Hotel *newHotel = (Hotel *)arenaAlloc(&hotelArena);
     if (newHotel == NULL) {
         printf("Memory allocation failed\n");
         return;
@@ -500,29 +1046,30 @@ void addHotel() {
     fgets(newHotel->name, sizeof(newHotel->name), stdin);
     newHotel->name[strcspn(newHotel->name, "\n")] = 0;
 
+    char location[LOCATION_MAX];
     printf("Enter location: ");
-    fgets(newHotel->location, sizeof(newHotel->location), stdin);
-    newHotel->location[strcspn(newHotel->location, "\n")] = 0;
+    fgets(location, sizeof(location), stdin);
+    location[strcspn(location, "\n")] = 0;
+    newHotel->location = internString(location);
 
     printf("Enter rooms available: ");
     scanf("%d", &newHotel->roomsAvailable);
     clearInputBuffer();
 
     newHotel->next = hotelsHead;
+    newHotel->prev = NULL;
+    if (hotelsHead != NULL) {
+        hotelsHead->prev = newHotel;
+    }
     hotelsHead = newHotel;
+    intIndexInsert(&hotelIndex, hotelID, newHotel);
+    hotelTokenIndexAdd(newHotel);
     printf("Hotel added successfully.\n");
 }
 
 
 bool hotelExists(int hotelID) {
-    Hotel *current = hotelsHead;
-    while (current != NULL) {
-        if (current->hotelID == hotelID) {
-            return true;
-        }
-        current = current->next;
-    }
-    return false;
+    return findHotel(hotelID) != NULL;
 }
 void deleteHotel() {
     int hotelID;
@@ -530,22 +1077,23 @@ void deleteHotel() {
     scanf("%d", &hotelID);
     clearInputBuffer();
 
-    Hotel *current = hotelsHead, *previous = NULL;
-    while (current != NULL) {
-        if (current->hotelID == hotelID) {
-            if (previous == NULL) {
-                hotelsHead = current->next;
-            } else {
-                previous->next = current->next;
-            }
-            free(current);
-            printf("Hotel ID %d deleted successfully.\n", hotelID);
-            return;
-        }
-        previous = current;
-        current = current->next;
+    Hotel *current = findHotel(hotelID);
+    if (current == NULL) {
+        printf("Hotel ID %d not found.\n", hotelID);
+        return;
+    }
+
+    if (current->prev == NULL) {
+        hotelsHead = current->next;
+    } else {
+        current->prev->next = current->next;
     }
-    printf("Hotel ID %d not found.\n", hotelID);
+    if (current->next != NULL) {
+        current->next->prev = current->prev;
+    }
+    intIndexRemove(&hotelIndex, hotelID);
+    hotelTokenIndexRemove(current);
+    printf("Hotel ID %d deleted successfully.\n", hotelID);
 }
 
 void editHotel() {
@@ -554,29 +1102,31 @@ void editHotel() {
     scanf("%d", &hotelID);
     clearInputBuffer();
 
-    Hotel *current = hotelsHead;
-    while (current != NULL) {
-        if (current->hotelID == hotelID) {
-            printf("Editing Hotel ID: %d\n", hotelID);
+    Hotel *current = findHotel(hotelID);
+    if (current == NULL) {
+        printf("Hotel ID %d not found.\n", hotelID);
+        return;
+    }
 
-            printf("Enter new hotel name: ");
-            fgets(current->name, sizeof(current->name), stdin);
-            current->name[strcspn(current->name, "\n")] = 0;
+    printf("Editing Hotel ID: %d\n", hotelID);
+    hotelTokenIndexRemove(current); // Name and location may change, re-indexed below
 
-            printf("Enter new location: ");
-            fgets(current->location, sizeof(current->location), stdin);
-            current->location[strcspn(current->location, "\n")] = 0;
+    printf("Enter new hotel name: ");
+    fgets(current->name, sizeof(current->name), stdin);
+    current->name[strcspn(current->name, "\n")] = 0;
 
-            printf("Enter new rooms available: ");
-            scanf("%d", &current->roomsAvailable);
-            clearInputBuffer();
+    char location[LOCATION_MAX];
+    printf("Enter new location: ");
+    fgets(location, sizeof(location), stdin);
+    location[strcspn(location, "\n")] = 0;
+    current->location = internString(location);
 
-            printf("Hotel details updated successfully.\n");
-            return;
-        }
-        current = current->next;
-    }
-    printf("Hotel ID %d not found.\n", hotelID);
+    printf("Enter new rooms available: ");
+    scanf("%d", &current->roomsAvailable);
+    clearInputBuffer();
+
+    hotelTokenIndexAdd(current);
+    printf("Hotel details updated successfully.\n");
 }
 
 void listHotels() {
@@ -587,11 +1137,309 @@ void listHotels() {
     }
     while (current != NULL) {
         printf("Hotel ID %d: %s, Location: %s, Rooms Available: %d\n",
-               current->hotelID, current->name, current->location, current->roomsAvailable);
+               current->hotelID, current->name, symbolName(current->location), current->roomsAvailable);
         current = current->next;
     }
 }
 
+//////////////////////////////////////////////////// TEXT FOLDING ////////////////////////////////////////////////////////////////////
+
+// Base letter of U+00C0 .. U+017F (Latin-1 letters and Latin Extended-A), indexed by code point - 0xC0; 0 = keep as is
+static const char foldTable[] =
+    "aaaaaaaceeeeiiiidnooooo" "\0" "ouuuuyts"   // U+00C0 À .. U+00DF ß
+    "aaaaaaaceeeeiiiidnooooo" "\0" "ouuuuyty"   // U+00E0 à .. U+00FF ÿ
+    "aaaaaa" "cccccccc" "dddd" "eeeeeeeeee" "gggggggg" "hhhh" "iiiiiiiiii" "ii" "jj" "kkk"
+    "llllllllll" "nnnnnnnnn" "oooooo" "oo" "rrrrrr" "ssssssss" "tttttt" "uuuuuuuuuuuu" "ww" "yyy" "zzzzzz" "s";
+
+// Folds the character at *cursor into out (1 to 4 bytes) and moves past it: ASCII is lower-cased, accented Latin
+// letters lose their accent, any other UTF-8 sequence is copied unchanged
+static size_t foldChar(const unsigned char **cursor, char *out) {
+    const unsigned char *p = *cursor;
+    size_t length = 1;
+    if (p[0] >= 0xC0 && p[0] < 0xF8) {
+        length = p[0] < 0xE0 ? 2 : p[0] < 0xF0 ? 3 : 4;
+        for (size_t i = 1; i < length; i++) {
+            if ((p[i] & 0xC0) != 0x80) {
+                length = 1; // Broken sequence, the byte is taken alone
+                break;
+            }
+        }
+    }
+    *cursor = p + length;
+
+    if (length == 1) {
+        out[0] = (char)(p[0] < 0x80 ? tolower(p[0]) : p[0]);
+        return 1;
+    }
+    if (length == 2) {
+        unsigned int codePoint = ((p[0] & 0x1Fu) << 6) | (p[1] & 0x3Fu);
+        if (codePoint >= 0xC0 && codePoint < 0x180 && foldTable[codePoint - 0xC0] != '\0') {
+            out[0] = foldTable[codePoint - 0xC0];
+            return 1;
+        }
+    }
+    memcpy(out, p, length);
+    return length;
+}
+
+// "São Paulo" -> "sao paulo"; the result is never longer than the text. Returns its length
+size_t foldText(const char *text, char *out, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    const unsigned char *p = (const unsigned char *)text;
+    size_t length = 0;
+    while (*p) {
+        char folded[4];
+        size_t bytes = foldChar(&p, folded);
+        if (length + bytes >= size) break;
+        memcpy(out + length, folded, bytes);
+        length += bytes;
+    }
+    out[length] = '\0';
+    return length;
+}
+
+//////////////////////////////////////////////////// HOTEL SEARCH ////////////////////////////////////////////////////////////////////
+
+#define TOKEN_MAX 100
+#define QUERY_MAX_TOKENS 16
+
+// Splits text on anything that is not a letter or digit and folds it (foldText); other UTF-8 bytes (>= 0x80) stay inside the token
+static bool nextToken(const char **cursor, char *token) {
+    const unsigned char *p = (const unsigned char *)*cursor;
+    while (*p && !(isalnum(*p) || *p >= 0x80)) {
+        p++;
+    }
+    if (*p == '\0') {
+        *cursor = (const char *)p;
+        return false;
+    }
+    size_t length = 0;
+    while (*p && (isalnum(*p) || *p >= 0x80)) {
+        char folded[4];
+        size_t bytes = foldChar(&p, folded);
+        if (length + bytes < TOKEN_MAX) {
+            memcpy(token + length, folded, bytes);
+            length += bytes;
+        }
+    }
+    token[length] = '\0';
+    *cursor = (const char *)p;
+    return true;
+}
+
+static int compareHotelIDs(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Also drops the repeats a duplicated hotelID in hotels.txt leaves behind
+static void postingListSort(PostingList *list) {
+    if (list->sorted) {
+        return;
+    }
+    qsort(list->hotelIDs, list->count, sizeof(int), compareHotelIDs);
+    int kept = 0;
+    for (int i = 0; i < list->count; i++) {
+        if (kept == 0 || list->hotelIDs[kept - 1] != list->hotelIDs[i]) {
+            list->hotelIDs[kept++] = list->hotelIDs[i];
+        }
+    }
+    list->count = kept;
+    list->sorted = true;
+}
+
+// Position of hotelID in the (sorted) posting list, or where it would be inserted
+static int postingSearch(const PostingList *list, int hotelID) {
+    int low = 0, high = list->count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (list->hotelIDs[mid] < hotelID) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+static PostingList *postingListGet(const char *token, bool create) {
+    PostingList *list = (PostingList *)strIndexFind(&hotelTokenIndex, token);
+    if (list != NULL || !create) {
+        return list;
+    }
+
+    list = (PostingList *)calloc(1, sizeof(PostingList));
+    if (list != NULL) {
+        list->token = (char *)malloc(strlen(token) + 1);
+    }
+    if (list == NULL || list->token == NULL) {
+        free(list);
+        perror("Failed to allocate memory for hotel index");
+        return NULL;
+    }
+    strcpy(list->token, token);
+    list->sorted = true;
+    strIndexInsert(&hotelTokenIndex, list->token, list);
+    return list;
+}
+
+static void postingListAdd(const char *token, int hotelID) {
+    PostingList *list = postingListGet(token, true);
+    if (list == NULL) {
+        return;
+    }
+    // A hotel's tokens are added together, so a repeat (token in both name and location) is always the last entry
+    if (list->count > 0 && list->hotelIDs[list->count - 1] == hotelID) {
+        return;
+    }
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 4;
+        int *ids = (int *)realloc(list->hotelIDs, capacity * sizeof(int));
+        if (ids == NULL) {
+            perror("Failed to allocate memory for hotel index");
+            return;
+        }
+        list->hotelIDs = ids;
+        list->capacity = capacity;
+    }
+    // Always an append, whatever the order of hotels.txt; a smaller id only marks the list for sorting
+    if (list->count > 0 && list->hotelIDs[list->count - 1] > hotelID) {
+        list->sorted = false;
+    }
+    list->hotelIDs[list->count++] = hotelID;
+}
+
+static void postingListRemove(const char *token, int hotelID) {
+    PostingList *list = postingListGet(token, false);
+    if (list == NULL) {
+        return;
+    }
+    postingListSort(list);
+    int position = postingSearch(list, hotelID);
+    if (position < list->count && list->hotelIDs[position] == hotelID) {
+        memmove(&list->hotelIDs[position], &list->hotelIDs[position + 1], (list->count - position - 1) * sizeof(int));
+        list->count--;
+    }
+}
+
+// Must be called whenever a hotel enters the catalog or its name/location changes
+void hotelTokenIndexAdd(const Hotel *hotel) {
+    cityTrie.dirty = true;
+    char token[TOKEN_MAX];
+    const char *fields[2] = {hotel->name, symbolName(hotel->location)};
+    for (int i = 0; i < 2; i++) {
+        const char *cursor = fields[i];
+        while (nextToken(&cursor, token)) {
+            postingListAdd(token, hotel->hotelID);
+        }
+    }
+}
+
+void hotelTokenIndexRemove(const Hotel *hotel) {
+    cityTrie.dirty = true;
+    char token[TOKEN_MAX];
+    const char *fields[2] = {hotel->name, symbolName(hotel->location)};
+    for (int i = 0; i < 2; i++) {
+        const char *cursor = fields[i];
+        while (nextToken(&cursor, token)) {
+            postingListRemove(token, hotel->hotelID);
+        }
+    }
+}
+
+// Hotels matching every keyword of the query, sorted by hotelID; the caller frees the result (NULL when none)
+int *findHotelsByKeywords(const char *query, int *count) {
+    const PostingList *lists[QUERY_MAX_TOKENS];
+    int listCount = 0;
+    char token[TOKEN_MAX];
+    *count = 0;
+
+    while (listCount < QUERY_MAX_TOKENS && nextToken(&query, token)) {
+        PostingList *list = postingListGet(token, false);
+        if (list == NULL || list->count == 0) {
+            return NULL; // A keyword nobody has, the intersection is empty
+        }
+        postingListSort(list);
+        // Keep the lists ordered by size, the smallest one drives the intersection
+        int i = listCount++;
+        while (i > 0 && lists[i - 1]->count > list->count) {
+            lists[i] = lists[i - 1];
+            i--;
+        }
+        lists[i] = list;
+    }
+    if (listCount == 0) {
+        return NULL;
+    }
+
+    int *results = (int *)malloc(lists[0]->count * sizeof(int));
+    if (results == NULL) {
+        perror("Failed to allocate memory for search results");
+        return NULL;
+    }
+    memcpy(results, lists[0]->hotelIDs, lists[0]->count * sizeof(int));
+    int found = lists[0]->count;
+
+    for (int l = 1; l < listCount && found > 0; l++) {
+        int kept = 0;
+        for (int i = 0; i < found; i++) {
+            int position = postingSearch(lists[l], results[i]);
+            if (position < lists[l]->count && lists[l]->hotelIDs[position] == results[i]) {
+                results[kept++] = results[i];
+            }
+        }
+        found = kept;
+    }
+
+    if (found == 0) {
+        free(results);
+        return NULL;
+    }
+    *count = found;
+    return results;
+}
+
+void searchHotels() {
+    char query[150];
+    printf("Enter hotel name or location keywords (leave empty for all): ");
+    fgets(query, sizeof(query), stdin);
+    query[strcspn(query, "\n")] = 0;
+
+    const char *cursor = query;
+    char token[TOKEN_MAX];
+    if (!nextToken(&cursor, token)) {
+        listHotelsUser();
+        return;
+    }
+
+    int count;
+    int *hotelIDs = findHotelsByKeywords(query, &count);
+    if (hotelIDs == NULL) {
+        // No hotel has every word: fall back to the names closest to what was typed
+        FuzzyMatch matches[AUTOCOMPLETE_TOP_K];
+        count = fuzzySearchNames(query, FUZZY_HOTEL, matches, AUTOCOMPLETE_TOP_K);
+        if (count == 0) {
+            printf("No hotels found for this search.\n");
+            return;
+        }
+        printf("No exact match, closest hotel name(s):\n");
+        for (int i = 0; i < count; i++) {
+            Hotel *hotel = findHotel(matches[i].entry->hotelID);
+            if (hotel != NULL) {
+                printHotelAvailability(hotel);
+            }
+        }
+        return;
+    }
+    printf("%d hotel(s) found:\n", count);
+    for (int i = 0; i < count; i++) {
+        Hotel *hotel = findHotel(hotelIDs[i]);
+        if (hotel != NULL) {
+            printHotelAvailability(hotel);
+        }
+    }
+    free(hotelIDs);
+}
+
 //////////////////////////////////////////////////// FLIGHT HANDLING ////////////////////////////////////////////////////////////////////
 void addFlight() {
     int flightNumber;
@@ -604,20 +1452,23 @@ void addFlight() {
         return;
     }
 
-    Flight *newFlight = (Flight *)malloc(sizeof(Flight));
+    Flight *newFlight = (Flight *)arenaAlloc(&flightArena);
     if (newFlight == NULL) {
         printf("Memory allocation failed\n");
         return;
     }
     newFlight->flightNumber = flightNumber;
 
+    char city[CITY_NAME_MAX];
     printf("Enter origin: ");
-    fgets(newFlight->origin, sizeof(newFlight->origin), stdin);
-    newFlight->origin[strcspn(newFlight->origin, "\n")] = 0;
+    fgets(city, sizeof(city), stdin);
+    city[strcspn(city, "\n")] = 0;
+    newFlight->origin = internString(city);
 
     printf("Enter destination: ");
-    fgets(newFlight->destination, sizeof(newFlight->destination), stdin);
-    newFlight->destination[strcspn(newFlight->destination, "\n")] = 0;
+    fgets(city, sizeof(city), stdin);
+    city[strcspn(city, "\n")] = 0;
+    newFlight->destination = internString(city);
 
     printf("Enter departure time: ");
     fgets(newFlight->departureTime, sizeof(newFlight->departureTime), stdin);
@@ -630,22 +1481,22 @@ void addFlight() {
     printf("Enter seats available: ");
     scanf("%d", &newFlight->seatsAvailable);
     clearInputBuffer();
+    parseFlightTimes(newFlight);
 
     newFlight->next = flightsHead;
+    newFlight->prev = NULL;
+    if (flightsHead != NULL) {
+        flightsHead->prev = newFlight;
+    }
     flightsHead = newFlight;
+    intIndexInsert(&flightIndex, flightNumber, newFlight);
+    routeIndexAdd(newFlight);
     printf("Flight added successfully.\n");
 }
 
 
 bool flightExists(int flightNumber) {
-    Flight *current = flightsHead;
-    while (current != NULL) {
-        if (current->flightNumber == flightNumber) {
-            return true;
-        }
-        current = current->next;
-    }
-    return false;
+    return findFlight(flightNumber) != NULL;
 }
 
 void deleteFlight() {
@@ -654,22 +1505,23 @@ void deleteFlight() {
     scanf("%d", &flightNumber);
     clearInputBuffer();
 
-    Flight *current = flightsHead, *previous = NULL;
-    while (current != NULL) {
-        if (current->flightNumber == flightNumber) {
-            if (previous == NULL) {
-                flightsHead = current->next;
-            } else {
-                previous->next = current->next;
-            }
-            free(current);
-            printf("Flight %d deleted successfully.\n", flightNumber);
-            return;
-        }
-        previous = current;
-        current = current->next;
+    Flight *current = findFlight(flightNumber);
+    if (current == NULL) {
+        printf("Flight number %d not found.\n", flightNumber);
+        return;
+    }
+
+    if (current->prev == NULL) {
+        flightsHead = current->next;
+    } else {
+        current->prev->next = current->next;
     }
-    printf("Flight number %d not found.\n", flightNumber);
+    if (current->next != NULL) {
+        current->next->prev = current->prev;
+    }
+    intIndexRemove(&flightIndex, flightNumber);
+    routeIndexRemove(current);
+    printf("Flight %d deleted successfully.\n", flightNumber);
 }
 
 void editFlight() {
@@ -678,37 +1530,41 @@ void editFlight() {
     scanf("%d", &flightNumber);
     clearInputBuffer();
 
-    Flight *current = flightsHead;
-    while (current != NULL) {
-        if (current->flightNumber == flightNumber) {
-            printf("Editing Flight Number: %d\n", flightNumber);
+    Flight *current = findFlight(flightNumber);
+    if (current == NULL) {
+        printf("Flight number %d not found.\n", flightNumber);
+        return;
+    }
 
-            printf("Enter new origin: ");
-            fgets(current->origin, sizeof(current->origin), stdin);
-            current->origin[strcspn(current->origin, "\n")] = 0;
+    printf("Editing Flight Number: %d\n", flightNumber);
+    routeIndexRemove(current); // Origin and destination may change, re-indexed below
 
-            printf("Enter new destination: ");
-            fgets(current->destination, sizeof(current->destination), stdin);
-            current->destination[strcspn(current->destination, "\n")] = 0;
+    char city[CITY_NAME_MAX];
+    printf("Enter new origin: ");
+    fgets(city, sizeof(city), stdin);
+    city[strcspn(city, "\n")] = 0;
+    current->origin = internString(city);
 
-            printf("Enter new departure time: ");
-            fgets(current->departureTime, sizeof(current->departureTime), stdin);
-            current->departureTime[strcspn(current->departureTime, "\n")] = 0;
+    printf("Enter new destination: ");
+    fgets(city, sizeof(city), stdin);
+    city[strcspn(city, "\n")] = 0;
+    current->destination = internString(city);
 
-            printf("Enter new arrival time: ");
-            fgets(current->arrivalTime, sizeof(current->arrivalTime), stdin);
-            current->arrivalTime[strcspn(current->arrivalTime, "\n")] = 0;
+    printf("Enter new departure time: ");
+    fgets(current->departureTime, sizeof(current->departureTime), stdin);
+    current->departureTime[strcspn(current->departureTime, "\n")] = 0;
 
-            printf("Enter new seats available: ");
-            scanf("%d", &current->seatsAvailable);
-            clearInputBuffer();
+    printf("Enter new arrival time: ");
+    fgets(current->arrivalTime, sizeof(current->arrivalTime), stdin);
+    current->arrivalTime[strcspn(current->arrivalTime, "\n")] = 0;
 
-            printf("Flight details updated successfully.\n");
-            return;
-        }
-        current = current->next;
-    }
-    printf("Flight number %d not found.\n", flightNumber);
+    printf("Enter new seats available: ");
+    scanf("%d", &current->seatsAvailable);
+    clearInputBuffer();
+
+    parseFlightTimes(current);
+    routeIndexAdd(current);
+    printf("Flight details updated successfully.\n");
 }
 
 
@@ -720,730 +1576,3761 @@ void listFlights() {
     }
     while (current != NULL) {
         printf("Flight %d: %s to %s, Departure: %s, Arrival: %s, Seats: %d\n",
-               current->flightNumber, current->origin, current->destination,
+               current->flightNumber, symbolName(current->origin), symbolName(current->destination),
                current->departureTime, current->arrivalTime, current->seatsAvailable);
         current = current->next;
     }
 }
 
 
-///////////////////////////////////////////////// REGISTER FUNCTION ADMIN OR USER ///////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////// FLIGHT SEARCH ////////////////////////////////////////////////////////////////////
 
-void registerUser() {
-    User *newUser = (User *)malloc(sizeof(User));
-    if (!newUser) {
-        perror("Memory allocation failed");
-        return;
+// Route keys use '|' as separator, it can never be part of a city because flights.txt is pipe-delimited
+// City keys are folded, so "sao paulo" finds the flights of "São Paulo"
+static void makeRouteKey(char *key, size_t size, const char *origin, const char *destination) {
+    size_t length = foldText(origin, key, size);
+    if (length + 1 < size) {
+        key[length++] = '|';
+        foldText(destination, key + length, size - length);
     }
+}
 
-    printf("Enter username: ");
-    scanf("%49s", newUser->username);
-    clearInputBuffer();
 
-    printf("Enter password: ");
-    scanf("%49s", newUser->password);
-    clearInputBuffer();
+static FlightBucket *flightBucketGet(StrIndex *index, const char *key, bool create) {
+    FlightBucket *bucket = (FlightBucket *)strIndexFind(index, key);
+    if (bucket != NULL || !create) {
+        return bucket;
+    }
 
-    printf("Is this an admin account? (1 for Yes, 0 for No): ");
-    scanf("%d", &newUser->isAdmin);
-    clearInputBuffer();
+    bucket = (FlightBucket *)calloc(1, sizeof(FlightBucket));
+    if (bucket != NULL) {
+        bucket->key = (char *)malloc(strlen(key) + 1);
+    }
+    if (bucket == NULL || bucket->key == NULL) {
+        free(bucket);
+        perror("Failed to allocate memory for flight index");
+        return NULL;
+    }
+    strcpy(bucket->key, key);
+    strIndexInsert(index, bucket->key, bucket);
+    return bucket;
+}
 
-    // Prevent memory leak by initializing the next pointer to NULL
-    newUser->next = NULL;
+static FlightBucket *cityBucket(StrIndex *index, const char *city) {
+    char key[TOKEN_MAX];
+    foldText(city, key, sizeof(key));
+    return flightBucketGet(index, key, false);
+}
 
-    // Check if username already exists
-    User *current = head, *last = NULL;
-    while (current != NULL) {
-        if (strcmp(current->username, newUser->username) == 0) {
-            printf("This username already exists.\n");
-            free(newUser);
+static void flightBucketPush(FlightBucket *bucket, Flight *flight) {
+    if (bucket->count == bucket->capacity) {
+        int capacity = bucket->capacity ? bucket->capacity * 2 : 4;
+        Flight **flights = (Flight **)realloc(bucket->flights, capacity * sizeof(Flight *));
+        if (flights == NULL) {
+            perror("Failed to allocate memory for flight index");
             return;
         }
-        last = current;
-        current = current->next;
+        bucket->flights = flights;
+        bucket->capacity = capacity;
     }
+    bucket->flights[bucket->count++] = flight;
+    bucket->sorted = false;
+}
 
-    // Insert at the end or as the first element
-    if (last == NULL) { // No users yet, add as the first user
-        head = newUser;
-    } else {
-        last->next = newUser; // Add new user at the end of the list
+// Keeps the order, so a sorted bucket stays sorted
+static void flightBucketErase(FlightBucket *bucket, const Flight *flight) {
+    for (int i = 0; i < bucket->count; i++) {
+        if (bucket->flights[i] == flight) {
+            memmove(&bucket->flights[i], &bucket->flights[i + 1], (bucket->count - i - 1) * sizeof(Flight *));
+            bucket->count--;
+            return;
+        }
     }
-    saveUsers();
-    printf("User registered successfully!\n");
 }
 
-///////////////////////////////////////////////// LOGIN FUNCTION ADMIN OR USER ///////////////////////////////////////////////////////////////////////
-int loginUser(int expectedAdmin) {
-    char username[50];
-    char password[50];
-    printf("Enter username: ");
-    scanf("%49s", username);
-    clearInputBuffer();
-    printf("Enter password: ");
-    scanf("%49s", password);
-    clearInputBuffer();
+static void flightBucketAdd(StrIndex *index, const char *key, Flight *flight) {
+    FlightBucket *bucket = flightBucketGet(index, key, true);
+    if (bucket != NULL) {
+        flightBucketPush(bucket, flight);
+    }
+}
 
-    User *current = head;
-    while (current != NULL) {
-        if (strcmp(current->username, username) == 0 && strcmp(current->password, password) == 0) {
-            if (current->isAdmin == expectedAdmin) {
-                strcpy(currentUser, username);  //GUARDAR CURRENT USER PRAS OUTRAS FUNÇOES ESPECIFICAS( funçoes que necessitam de user especificio)
-                return current->isAdmin;  // Returns 1 for admin, 0 for regular user
-            } else {
-                printf("Access denied. Incorrect user role.\n");
-                return -1;  // Wrong type of user for the intended operation
+// Empty buckets are kept, the same route usually comes back
+static void flightBucketRemove(StrIndex *index, const char *key, const Flight *flight) {
+    FlightBucket *bucket = flightBucketGet(index, key, false);
+    if (bucket != NULL) {
+        flightBucketErase(bucket, flight);
+    }
+}
+
+// Departure time first, flight number breaks ties so the order is stable across sorts
+static int compareDepartures(const void *a, const void *b) {
+    const Flight *x = *(Flight *const *)a, *y = *(Flight *const *)b;
+    if (x->departureMinutes != y->departureMinutes) {
+        return x->departureMinutes < y->departureMinutes ? -1 : 1;
+    }
+    return (x->flightNumber > y->flightNumber) - (x->flightNumber < y->flightNumber);
+}
+
+static void flightBucketSort(FlightBucket *bucket) {
+    if (!bucket->sorted) {
+        if (bucket->count > 1) {
+            qsort(bucket->flights, bucket->count, sizeof(Flight *), compareDepartures);
+        }
+        bucket->sorted = true;
+        if (bucket == &departureIndex) {
+            for (int i = 0; i < bucket->count; i++) {
+                bucket->flights[i]->departureSlot = i;
             }
         }
-        current = current->next;
     }
+}
 
-    printf("Invalid username or password.\n");
-    return -1;
+static void departureIndexAdd(Flight *flight) {
+    flightBucketPush(&departureIndex, flight);
+    bool added = departureIndex.count > 0 && departureIndex.flights[departureIndex.count - 1] == flight;
+    flight->departureSlot = added ? departureIndex.count - 1 : -1;
 }
 
-void logout() {
-    currentUser[0] = '\0';
-    printf("You have been logged out.\n");
+// O(1): the last flight moves into the hole, the next query sorts again
+static void departureIndexRemove(Flight *flight) {
+    int slot = flight->departureSlot;
+    if (slot < 0 || slot >= departureIndex.count || departureIndex.flights[slot] != flight) {
+        return;
+    }
+    Flight *last = departureIndex.flights[--departureIndex.count];
+    if (last != flight) {
+        departureIndex.flights[slot] = last;
+        last->departureSlot = slot;
+        departureIndex.sorted = false;
+    }
+    flight->departureSlot = -1;
 }
 
+// First position in a sorted bucket whose departure is >= minutes
+static int flightBucketLowerBound(const FlightBucket *bucket, int minutes) {
+    int low = 0, high = bucket->count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (bucket->flights[mid]->departureMinutes < minutes) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
 
-//////////////////////////////////////////////// BINARY FOR USERS ////////////////////////////////////////////////////////////////////////
-void loadUsers() {
-    FILE *file = fopen("users.dat", "rb");
-    if (file == NULL) {
-        printf("No existing user file found; starting new.\n");
+// "7:00", "07:00" or "23:59" -> minutes since midnight; -1 for anything else
+int parseTimeOfDay(const char *text) {
+    while (*text == ' ') text++;
+    int hours = 0, minutes = 0, digits = 0;
+    while (isdigit((unsigned char)*text) && digits < 2) {
+        hours = hours * 10 + (*text++ - '0');
+        digits++;
+    }
+    if (digits == 0 || *text++ != ':') {
+        return -1;
+    }
+    if (!isdigit((unsigned char)text[0]) || !isdigit((unsigned char)text[1])) {
+        return -1;
+    }
+    minutes = (text[0] - '0') * 10 + (text[1] - '0');
+    text += 2;
+    while (*text == ' ') text++;
+    if (*text != '\0' || hours > 23 || minutes > 59) {
+        return -1;
+    }
+    return hours * 60 + minutes;
+}
+
+// Call after departureTime/arrivalTime are set or edited
+void parseFlightTimes(Flight *flight) {
+    flight->departureMinutes = parseTimeOfDay(flight->departureTime);
+    flight->arrivalMinutes = parseTimeOfDay(flight->arrivalTime);
+}
+
+// Must be called whenever a flight enters the catalog or its origin/destination changes
+void routeIndexAdd(Flight *flight) {
+    cityTrie.dirty = true;
+    flightGraph.dirty = true;
+    char key[2 * CITY_NAME_MAX + 1];
+    makeRouteKey(key, sizeof(key), symbolName(flight->origin), symbolName(flight->destination));
+    flightBucketAdd(&routeIndex, key, flight);
+    foldText(symbolName(flight->origin), key, sizeof(key));
+    flightBucketAdd(&originIndex, key, flight);
+    foldText(symbolName(flight->destination), key, sizeof(key));
+    flightBucketAdd(&destinationIndex, key, flight);
+    departureIndexAdd(flight);
+}
+
+void routeIndexRemove(Flight *flight) {
+    cityTrie.dirty = true;
+    flightGraph.dirty = true;
+    char key[2 * CITY_NAME_MAX + 1];
+    makeRouteKey(key, sizeof(key), symbolName(flight->origin), symbolName(flight->destination));
+    flightBucketRemove(&routeIndex, key, flight);
+    foldText(symbolName(flight->origin), key, sizeof(key));
+    flightBucketRemove(&originIndex, key, flight);
+    foldText(symbolName(flight->destination), key, sizeof(key));
+    flightBucketRemove(&destinationIndex, key, flight);
+    departureIndexRemove(flight);
+}
+
+static FlightBucket *routeBucket(const char *origin, const char *destination) {
+    bool anyOrigin = origin == NULL || origin[0] == '\0';
+    bool anyDestination = destination == NULL || destination[0] == '\0';
+    FlightBucket *bucket = NULL;
+
+    if (!anyOrigin && !anyDestination) {
+        char key[2 * CITY_NAME_MAX + 1];
+        makeRouteKey(key, sizeof(key), origin, destination);
+        bucket = flightBucketGet(&routeIndex, key, false);
+    } else if (!anyOrigin) {
+        bucket = cityBucket(&originIndex, origin);
+    } else if (!anyDestination) {
+        bucket = cityBucket(&destinationIndex, destination);
+    } else {
+        bucket = &departureIndex;
+    }
+    if (bucket != NULL) {
+        flightBucketSort(bucket);
+    }
+    return bucket;
+}
+
+// Either side may be empty (or NULL) to match any city; flights come sorted by departure.
+// Returns NULL when nothing matches or both are empty
+const FlightBucket *findFlightsOnRoute(const char *origin, const char *destination) {
+    bool anyOrigin = origin == NULL || origin[0] == '\0';
+    bool anyDestination = destination == NULL || destination[0] == '\0';
+    if (anyOrigin && anyDestination) {
+        return NULL;
+    }
+    return routeBucket(origin, destination);
+}
+
+// Flights on the route (either side may be empty) departing in [fromMinutes, toMinutes], found by binary search.
+// *first points at the first match inside the index, the matches are contiguous; returns how many
+int findFlightsByDeparture(const char *origin, const char *destination, int fromMinutes, int toMinutes, Flight ***first) {
+    *first = NULL;
+    FlightBucket *bucket = routeBucket(origin, destination);
+    if (bucket == NULL || fromMinutes > toMinutes) {
+        return 0;
+    }
+    int low = flightBucketLowerBound(bucket, fromMinutes < 0 ? 0 : fromMinutes); // Unparsed (-1) times never match
+    int high = flightBucketLowerBound(bucket, toMinutes + 1);
+    *first = bucket->flights + low;
+    return high - low;
+}
+
+// Offers completions when the user typed only the start of a city name, or the closest names for a typo
+static void suggestCities(const char *typed) {
+    if (typed[0] == '\0' || cityBucket(&originIndex, typed) != NULL || cityBucket(&destinationIndex, typed) != NULL) {
+        return;
+    }
+    const char *completions[AUTOCOMPLETE_TOP_K];
+    int count = autocompleteCity(typed, completions, AUTOCOMPLETE_TOP_K);
+    if (count > 0) {
+        printf("Cities starting with '%s':", typed);
+        for (int i = 0; i < count; i++) {
+            printf("%s %s", i ? "," : "", completions[i]);
+        }
+        printf("\n");
         return;
     }
 
-    User *current = NULL, *temp;
-    head = NULL;
+    FuzzyMatch matches[AUTOCOMPLETE_TOP_K];
+    count = fuzzySearchNames(typed, FUZZY_CITY, matches, AUTOCOMPLETE_TOP_K);
+    if (count == 0) {
+        return;
+    }
+    printf("Did you mean:");
+    for (int i = 0; i < count; i++) {
+        printf("%s %s", i ? "," : "", matches[i].entry->display);
+    }
+    printf(" (instead of '%s')\n", typed);
+}
 
-    while (1) {
-        temp = (User *)malloc(sizeof(User));
-        if (temp == NULL) {
-            perror("Failed to allocate memory");
-            break;
+static void printItineraryTime(int minutes) {
+    printf("%02d:%02d (day %d)", (minutes % MINUTES_PER_DAY) / 60, minutes % 60, minutes / MINUTES_PER_DAY + 1);
+}
+
+// No direct flight between two cities: show the connecting itineraries instead; returns false if there are none
+static bool searchConnections(const char *origin, const char *destination) {
+    Itinerary itineraries[CONNECTION_MAX_LEGS];
+    int count = findConnections(origin, destination, CONNECTION_MAX_LEGS, MIN_CONNECTION_MINUTES, 0, itineraries);
+    if (count == 0) {
+        return false;
+    }
+
+    printf("No direct flights, %d connection(s) found (at least %d minutes between flights):\n", count, MIN_CONNECTION_MINUTES);
+    for (int i = 0; i < count; i++) {
+        printf("Itinerary %d: %d flight(s), arrives ", i + 1, itineraries[i].legCount);
+        printItineraryTime(itineraries[i].arriveAt);
+        printf("\n");
+        for (int l = 0; l < itineraries[i].legCount; l++) {
+            const ItineraryLeg *leg = &itineraries[i].legs[l];
+            printf("  Flight %d: %s ", leg->flight->flightNumber, symbolName(leg->flight->origin));
+            printItineraryTime(leg->departAt);
+            printf(" -> %s ", symbolName(leg->flight->destination));
+            printItineraryTime(leg->arriveAt);
+            printf("\n");
         }
-        if (fread(temp, sizeof(User) - sizeof(User*), 1, file) != 1) {
-            free(temp);
-            break;
+    }
+    return true;
+}
+
+// Window given as "HH:MM-HH:MM"; a window like 22:00-02:00 wraps past midnight
+static void searchFlightsByDeparture(const char *origin, const char *destination, const char *window) {
+    char from[20] = {0}, to[20] = {0};
+    const char *dash = strchr(window, '-');
+    if (dash == NULL || dash - window >= (long)sizeof(from) || strlen(dash + 1) >= sizeof(to)) {
+        printf("Invalid departure window, use HH:MM-HH:MM.\n");
+        return;
+    }
+    memcpy(from, window, dash - window);
+    strcpy(to, dash + 1);
+    int fromMinutes = parseTimeOfDay(from), toMinutes = parseTimeOfDay(to);
+    if (fromMinutes < 0 || toMinutes < 0) {
+        printf("Invalid departure window, use HH:MM-HH:MM.\n");
+        return;
+    }
+
+    Flight **first;
+    int total = 0;
+    if (fromMinutes <= toMinutes) {
+        total = findFlightsByDeparture(origin, destination, fromMinutes, toMinutes, &first);
+        for (int i = 0; i < total; i++) printFlightAvailability(first[i]);
+    } else {
+        int count = findFlightsByDeparture(origin, destination, fromMinutes, 23 * 60 + 59, &first);
+        for (int i = 0; i < count; i++) printFlightAvailability(first[i]);
+        total += count;
+        count = findFlightsByDeparture(origin, destination, 0, toMinutes, &first);
+        for (int i = 0; i < count; i++) printFlightAvailability(first[i]);
+        total += count;
+    }
+    if (total == 0) {
+        printf("No flights found for this search.\n");
+        suggestCities(origin);
+        suggestCities(destination);
+    } else {
+        printf("%d flight(s) found.\n", total);
+    }
+}
+
+void searchFlights() {
+    char origin[50], destination[50], window[40];
+
+    printf("Enter origin (leave empty for any): ");
+    fgets(origin, sizeof(origin), stdin);
+    origin[strcspn(origin, "\n")] = 0;
+
+    printf("Enter destination (leave empty for any): ");
+    fgets(destination, sizeof(destination), stdin);
+    destination[strcspn(destination, "\n")] = 0;
+
+    printf("Enter departure window HH:MM-HH:MM (leave empty for any): ");
+    fgets(window, sizeof(window), stdin);
+    window[strcspn(window, "\n")] = 0;
+
+    if (window[0] != '\0') {
+        searchFlightsByDeparture(origin, destination, window);
+        return;
+    }
+    if (origin[0] == '\0' && destination[0] == '\0') {
+        listFlightsUser();
+        return;
+    }
+
+    const FlightBucket *bucket = findFlightsOnRoute(origin, destination);
+    if ((bucket == NULL || bucket->count == 0) && origin[0] != '\0' && destination[0] != '\0' &&
+        searchConnections(origin, destination)) {
+        return;
+    }
+    if (bucket == NULL || bucket->count == 0) {
+        printf("No flights found for this search.\n");
+        suggestCities(origin);
+        suggestCities(destination);
+        return;
+    }
+    printf("%d flight(s) found:\n", bucket->count);
+    for (int i = 0; i < bucket->count; i++) {
+        printFlightAvailability(bucket->flights[i]);
+    }
+}
+
+//////////////////////////////////////////////////// CONNECTION SEARCH ////////////////////////////////////////////////////////////////////
+
+// Airports are keyed by folded name, like the route index
+static int airportId(const char *name, bool create) {
+    char key[TOKEN_MAX];
+    foldText(name, key, sizeof(key));
+    uintptr_t slot = (uintptr_t)strIndexFind(&flightGraph.airportIds, key);
+    if (slot != 0 || !create) {
+        return (int)slot - 1;
+    }
+    char **airports = (char **)realloc(flightGraph.airports, (flightGraph.airportCount + 1) * sizeof(char *));
+    if (airports == NULL) {
+        perror("Failed to allocate memory for flight graph");
+        return -1;
+    }
+    flightGraph.airports = airports;
+    char *copy = (char *)malloc(strlen(key) + 1);
+    if (copy == NULL) {
+        perror("Failed to allocate memory for flight graph");
+        return -1;
+    }
+    strcpy(copy, key);
+    airports[flightGraph.airportCount] = copy;
+    strIndexInsert(&flightGraph.airportIds, copy, (void *)(uintptr_t)(flightGraph.airportCount + 1));
+    return flightGraph.airportCount++;
+}
+
+static void freeFlightGraph() {
+    for (int i = 0; i < flightGraph.airportCount; i++) {
+        free(flightGraph.airports[i]);
+    }
+    free(flightGraph.airports);
+    free(flightGraph.edgeStart);
+    free(flightGraph.edges);
+    free(flightGraph.edgeTarget);
+    strIndexClear(&flightGraph.airportIds);
+    memset(&flightGraph, 0, sizeof(flightGraph));
+    flightGraph.dirty = true;
+}
+
+// Flights whose times do not parse are left out, they cannot be scheduled
+void buildFlightGraph() {
+    freeFlightGraph();
+
+    int edgeCount = 0;
+    for (Flight *flight = flightsHead; flight != NULL; flight = flight->next) {
+        if (flight->departureMinutes < 0 || flight->arrivalMinutes < 0) continue;
+        if (airportId(symbolName(flight->origin), true) < 0 || airportId(symbolName(flight->destination), true) < 0) return;
+        edgeCount++;
+    }
+
+    flightGraph.edgeStart = (int *)calloc(flightGraph.airportCount + 1, sizeof(int));
+    flightGraph.edges = (Flight **)malloc((edgeCount ? edgeCount : 1) * sizeof(Flight *));
+    flightGraph.edgeTarget = (int *)malloc((edgeCount ? edgeCount : 1) * sizeof(int));
+    int *fill = (int *)malloc((flightGraph.airportCount ? flightGraph.airportCount : 1) * sizeof(int));
+    if (flightGraph.edgeStart == NULL || flightGraph.edges == NULL || flightGraph.edgeTarget == NULL || fill == NULL) {
+        perror("Failed to allocate memory for flight graph");
+        free(fill);
+        freeFlightGraph();
+        return;
+    }
+
+    // Count the out-degree of each airport, turn it into offsets, then drop every edge in its slot
+    for (Flight *flight = flightsHead; flight != NULL; flight = flight->next) {
+        if (flight->departureMinutes < 0 || flight->arrivalMinutes < 0) continue;
+        flightGraph.edgeStart[airportId(symbolName(flight->origin), false) + 1]++;
+    }
+    for (int a = 0; a < flightGraph.airportCount; a++) {
+        flightGraph.edgeStart[a + 1] += flightGraph.edgeStart[a];
+    }
+    memcpy(fill, flightGraph.edgeStart, flightGraph.airportCount * sizeof(int));
+    for (Flight *flight = flightsHead; flight != NULL; flight = flight->next) {
+        if (flight->departureMinutes < 0 || flight->arrivalMinutes < 0) continue;
+        int edge = fill[airportId(symbolName(flight->origin), false)]++;
+        flightGraph.edges[edge] = flight;
+        flightGraph.edgeTarget[edge] = airportId(symbolName(flight->destination), false);
+    }
+    free(fill);
+    flightGraph.dirty = false;
+}
+
+/*
+ * Earliest-arrival itineraries from origin to destination, every flight operating daily.
+ * Round k knows the earliest arrival at each airport using at most k flights, and only airports improved
+ * in round k - 1 are expanded, so a query costs O(maxLegs * flights) at worst.
+ * A flight that lands before it takes off (22:00 -> 06:50) arrives the next day.
+ * results gets one itinerary per number of flights that arrives strictly earlier than any itinerary
+ * with fewer flights, fewest flights first; returns how many.
+ */
+int findConnections(const char *origin, const char *destination, int maxLegs, int minConnection, int startMinutes, Itinerary *results) {
+    if (flightGraph.dirty) {
+        buildFlightGraph();
+        if (flightGraph.dirty) return 0;
+    }
+    if (maxLegs > CONNECTION_MAX_LEGS) maxLegs = CONNECTION_MAX_LEGS;
+    int from = airportId(origin, false), to = airportId(destination, false);
+    if (from < 0 || to < 0 || from == to || maxLegs < 1) {
+        return 0;
+    }
+
+    int airports = flightGraph.airportCount;
+    size_t cells = (size_t)(maxLegs + 1) * airports;
+    // Per round and airport: arrival time, the edge used (-1 = kept from the previous round), its departure and start airport
+    int *arrive = (int *)malloc(cells * sizeof(int));
+    int *viaEdge = (int *)malloc(cells * sizeof(int));
+    int *departAt = (int *)malloc(cells * sizeof(int));
+    int *viaAirport = (int *)malloc(cells * sizeof(int));
+    bool *improved = (bool *)calloc(2 * (size_t)airports, sizeof(bool));
+    if (!arrive || !viaEdge || !departAt || !viaAirport || !improved) {
+        perror("Failed to allocate memory for connection search");
+        free(arrive); free(viaEdge); free(departAt); free(viaAirport); free(improved);
+        return 0;
+    }
+    for (size_t i = 0; i < cells; i++) {
+        arrive[i] = INT32_MAX;
+        viaEdge[i] = -1;
+    }
+    arrive[from] = startMinutes;
+    improved[from] = true;
+
+    for (int k = 1; k <= maxLegs; k++) {
+        int *previous = arrive + (size_t)(k - 1) * airports;
+        int *current = arrive + (size_t)k * airports;
+        bool *wasImproved = improved + ((k - 1) % 2) * airports;
+        bool *isImproved = improved + (k % 2) * airports;
+        memcpy(current, previous, airports * sizeof(int));
+        memset(isImproved, 0, airports * sizeof(bool));
+
+        for (int a = 0; a < airports; a++) {
+            if (!wasImproved[a]) continue;
+            int ready = previous[a] + (k > 1 ? minConnection : 0);
+            for (int e = flightGraph.edgeStart[a]; e < flightGraph.edgeStart[a + 1]; e++) {
+                const Flight *flight = flightGraph.edges[e];
+                // Next daily departure at or after "ready"
+                int departure = (ready / MINUTES_PER_DAY) * MINUTES_PER_DAY + flight->departureMinutes;
+                if (departure < ready) departure += MINUTES_PER_DAY;
+                int duration = (flight->arrivalMinutes - flight->departureMinutes + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+                int arrival = departure + duration;
+
+                int target = flightGraph.edgeTarget[e];
+                size_t slot = (size_t)k * airports + target;
+                if (arrival < current[target]) {
+                    current[target] = arrival;
+                    viaEdge[slot] = e;
+                    departAt[slot] = departure;
+                    viaAirport[slot] = a;
+                    isImproved[target] = true;
+                }
+            }
         }
-        temp->next = NULL;
+    }
 
-        if (head == NULL) {
-            head = temp;
-            current = head;
-        } else {
-            current->next = temp;
-            current = temp;
+    int found = 0;
+    for (int k = 1; k <= maxLegs; k++) {
+        if (arrive[(size_t)k * airports + to] >= arrive[(size_t)(k - 1) * airports + to]) continue;
+
+        // Walk back through the rounds; a round that did not improve an airport inherits it from the one before
+        Itinerary *itinerary = &results[found++];
+        itinerary->legCount = 0;
+        itinerary->arriveAt = arrive[(size_t)k * airports + to];
+        int airport = to;
+        for (int r = k; r > 0; r--) {
+            size_t slot = (size_t)r * airports + airport;
+            if (viaEdge[slot] < 0) continue;
+            ItineraryLeg *leg = &itinerary->legs[itinerary->legCount++];
+            leg->flight = flightGraph.edges[viaEdge[slot]];
+            leg->departAt = departAt[slot];
+            leg->arriveAt = arrive[slot];
+            airport = viaAirport[slot];
+        }
+        // Legs were collected from the destination backwards
+        for (int i = 0; i < itinerary->legCount / 2; i++) {
+            ItineraryLeg swap = itinerary->legs[i];
+            itinerary->legs[i] = itinerary->legs[itinerary->legCount - 1 - i];
+            itinerary->legs[itinerary->legCount - 1 - i] = swap;
         }
     }
-    fclose(file);
+
+    free(arrive); free(viaEdge); free(departAt); free(viaAirport); free(improved);
+    return found;
 }
-void saveUsers() {
-    FILE *file = fopen("users.dat", "wb");
-    if (file == NULL) {
-        perror("Failed to open file for writing");
+
+//////////////////////////////////////////////////// FUZZY NAME SEARCH ////////////////////////////////////////////////////////////////////
+
+static int compareTrigrams(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Distinct trigrams of " key " (3 bytes packed per int); the padding makes word edges and short names count.
+// trigrams needs room for TOKEN_MAX entries
+static int collectTrigrams(const char *key, int *trigrams) {
+    char padded[TOKEN_MAX + 2];
+    size_t length = strlen(key);
+    if (length > TOKEN_MAX - 1) length = TOKEN_MAX - 1;
+    padded[0] = ' ';
+    memcpy(padded + 1, key, length);
+    padded[length + 1] = ' ';
+    length += 2;
+
+    int count = 0;
+    for (size_t i = 0; i + 3 <= length; i++) {
+        trigrams[count++] = ((unsigned char)padded[i] << 16) | ((unsigned char)padded[i + 1] << 8) | (unsigned char)padded[i + 2];
+    }
+    qsort(trigrams, count, sizeof(int), compareTrigrams);
+    int distinct = 0;
+    for (int i = 0; i < count; i++) {
+        if (distinct == 0 || trigrams[distinct - 1] != trigrams[i]) trigrams[distinct++] = trigrams[i];
+    }
+    return distinct;
+}
+
+static TrigramPostings *trigramList(int trigram, bool create) {
+    uintptr_t slot = (uintptr_t)intIndexFind(&nameTrigrams.listIds, trigram);
+    if (slot != 0) {
+        return &nameTrigrams.lists[slot - 1];
+    }
+    if (!create) {
+        return NULL;
+    }
+    TrigramPostings *lists = (TrigramPostings *)realloc(nameTrigrams.lists, (nameTrigrams.listCount + 1) * sizeof(TrigramPostings));
+    if (lists == NULL) {
+        perror("Failed to allocate memory for fuzzy search");
+        return NULL;
+    }
+    nameTrigrams.lists = lists;
+    memset(&lists[nameTrigrams.listCount], 0, sizeof(TrigramPostings));
+    if (!intIndexInsert(&nameTrigrams.listIds, trigram, (void *)(uintptr_t)(nameTrigrams.listCount + 1))) {
+        return NULL;
+    }
+    return &lists[nameTrigrams.listCount++];
+}
+
+static bool addFuzzyEntry(FuzzyKind kind, const char *display, const char *name, int hotelID, int *capacity) {
+    char key[TOKEN_MAX];
+    if (foldText(name, key, sizeof(key)) == 0) {
+        return true;
+    }
+    if (nameTrigrams.entryCount == *capacity) {
+        int newCapacity = *capacity ? *capacity * 2 : 64;
+        FuzzyEntry *grown = (FuzzyEntry *)realloc(nameTrigrams.entries, newCapacity * sizeof(FuzzyEntry));
+        if (grown == NULL) {
+            perror("Failed to allocate memory for fuzzy search");
+            return false;
+        }
+        nameTrigrams.entries = grown;
+        *capacity = newCapacity;
+    }
+    FuzzyEntry *entry = &nameTrigrams.entries[nameTrigrams.entryCount];
+    entry->key = (char *)malloc(strlen(key) + 1);
+    if (entry->key == NULL) {
+        perror("Failed to allocate memory for fuzzy search");
+        return false;
+    }
+    strcpy(entry->key, key);
+    entry->kind = kind;
+    entry->display = display;
+    entry->hotelID = hotelID;
+
+    int trigrams[TOKEN_MAX];
+    entry->trigramCount = collectTrigrams(key, trigrams);
+    int id = nameTrigrams.entryCount++;
+    for (int i = 0; i < entry->trigramCount; i++) {
+        TrigramPostings *list = trigramList(trigrams[i], true);
+        if (list == NULL) {
+            return false;
+        }
+        if (list->count == list->capacity) {
+            int newCapacity = list->capacity ? list->capacity * 2 : 4;
+            int *grown = (int *)realloc(list->entries, newCapacity * sizeof(int));
+            if (grown == NULL) {
+                perror("Failed to allocate memory for fuzzy search");
+                return false;
+            }
+            list->entries = grown;
+            list->capacity = newCapacity;
+        }
+        list->entries[list->count++] = id;
+    }
+    return true;
+}
+
+static void freeNameTrigrams() {
+    for (int i = 0; i < nameTrigrams.entryCount; i++) {
+        free(nameTrigrams.entries[i].key);
+    }
+    for (int i = 0; i < nameTrigrams.listCount; i++) {
+        free(nameTrigrams.lists[i].entries);
+    }
+    free(nameTrigrams.entries);
+    free(nameTrigrams.lists);
+    free(nameTrigrams.shared);
+    free(nameTrigrams.touched);
+    intIndexClear(&nameTrigrams.listIds);
+    memset(&nameTrigrams, 0, sizeof(nameTrigrams));
+}
+
+// Called by buildCityTrie: every city of the trie plus every hotel name, folded once here
+static void buildNameTrigrams() {
+    freeNameTrigrams();
+    int capacity = 0;
+    for (int i = 0; i < cityTrie.cityCount; i++) {
+        if (!addFuzzyEntry(FUZZY_CITY, cityTrie.cities[i].display, cityTrie.cities[i].key, 0, &capacity)) {
+            freeNameTrigrams();
+            return;
+        }
+    }
+    for (Hotel *hotel = hotelsHead; hotel != NULL; hotel = hotel->next) {
+        if (!addFuzzyEntry(FUZZY_HOTEL, hotel->name, hotel->name, hotel->hotelID, &capacity)) {
+            freeNameTrigrams();
+            return;
+        }
+    }
+    int size = nameTrigrams.entryCount ? nameTrigrams.entryCount : 1;
+    nameTrigrams.shared = (int *)calloc(size, sizeof(int));
+    nameTrigrams.touched = (int *)malloc(size * sizeof(int));
+    if (nameTrigrams.shared == NULL || nameTrigrams.touched == NULL) {
+        perror("Failed to allocate memory for fuzzy search");
+        freeNameTrigrams();
+    }
+}
+
+/*
+ * Closest city or hotel names to query, typos and missing accents included, best score first; returns how many.
+ * Only the posting lists of the query's trigrams are walked, so entries sharing nothing with it are never looked at.
+ * An entry needs at least a third of the query's trigrams, otherwise any common syllable would match.
+ */
+int fuzzySearchNames(const char *query, FuzzyKind kind, FuzzyMatch *results, int maxResults) {
+    if (cityTrie.dirty) {
+        buildCityTrie();
+        if (cityTrie.dirty) return 0;
+    }
+    char key[TOKEN_MAX];
+    if (nameTrigrams.shared == NULL || foldText(query, key, sizeof(key)) == 0) {
+        return 0;
+    }
+    int trigrams[TOKEN_MAX];
+    int queryCount = collectTrigrams(key, trigrams);
+
+    int touchedCount = 0;
+    for (int q = 0; q < queryCount; q++) {
+        const TrigramPostings *list = trigramList(trigrams[q], false);
+        if (list == NULL) continue;
+        for (int i = 0; i < list->count; i++) {
+            if (nameTrigrams.shared[list->entries[i]]++ == 0) {
+                nameTrigrams.touched[touchedCount++] = list->entries[i];
+            }
+        }
+    }
+
+    int found = 0;
+    for (int t = 0; t < touchedCount; t++) {
+        int id = nameTrigrams.touched[t];
+        int shared = nameTrigrams.shared[id];
+        nameTrigrams.shared[id] = 0; // Scratch is clean again for the next query
+        const FuzzyEntry *entry = &nameTrigrams.entries[id];
+        if (entry->kind != kind || 3 * shared < queryCount) continue;
+
+        int score = 100 * shared / (queryCount + entry->trigramCount - shared);
+        int position = found < maxResults ? found : maxResults;
+        while (position > 0 && results[position - 1].score < score) {
+            position--;
+        }
+        if (position >= maxResults) continue;
+        int last = found < maxResults ? found : maxResults - 1;
+        memmove(&results[position + 1], &results[position], (last - position) * sizeof(FuzzyMatch));
+        results[position].entry = entry;
+        results[position].score = score;
+        if (found < maxResults) found++;
+    }
+    return found;
+}
+
+//////////////////////////////////////////////////// CITY AUTOCOMPLETE ////////////////////////////////////////////////////////////////////
+
+static int compareCityKeys(const void *a, const void *b) {
+    return strcmp(((const CityEntry *)a)->key, ((const CityEntry *)b)->key);
+}
+
+static void addCity(StrIndex *seen, CityEntry **cities, int *count, int *capacity, const char *name) {
+    char key[TOKEN_MAX];
+    size_t length = foldText(name, key, sizeof(key));
+    if (length == 0) {
         return;
     }
 
-    User *current = head;
-    while (current != NULL) {
-        fwrite(current, sizeof(User) - sizeof(User*), 1, file);
-        current = current->next;
+    uintptr_t slot = (uintptr_t)strIndexFind(seen, key);
+    if (slot != 0) {
+        (*cities)[slot - 1].weight++;
+        return;
+    }
+    if (*count == *capacity) {
+        int newCapacity = *capacity ? *capacity * 2 : 64;
+        CityEntry *grown = (CityEntry *)realloc(*cities, newCapacity * sizeof(CityEntry));
+        if (grown == NULL) {
+            perror("Failed to allocate memory for city autocomplete");
+            return;
+        }
+        *cities = grown;
+        *capacity = newCapacity;
+    }
+    CityEntry *city = &(*cities)[*count];
+    city->display = (char *)malloc(strlen(name) + 1);
+    city->key = (char *)malloc(length + 1);
+    if (city->display == NULL || city->key == NULL) {
+        free(city->display);
+        free(city->key);
+        perror("Failed to allocate memory for city autocomplete");
+        return;
     }
+    strcpy(city->display, name);
+    strcpy(city->key, key);
+    city->weight = 1;
+    (*count)++;
+    strIndexInsert(seen, city->key, (void *)(uintptr_t)*count);
+}
 
-    fclose(file);
+// Fills nodes[index] for the cities [low, high) that share their first "depth" key bytes, then its children
+static void buildTrieNode(int index, int low, int high, int depth) {
+    TrieNode *node = &cityTrie.nodes[index];
+    CityEntry *cities = cityTrie.cities;
+
+    // Top-k of the range: cities are in key order, so ties stay alphabetical
+    node->topCount = 0;
+    for (int i = low; i < high; i++) {
+        int position = node->topCount;
+        while (position > 0 && cities[node->top[position - 1]].weight < cities[i].weight) {
+            position--;
+        }
+        if (position >= AUTOCOMPLETE_TOP_K) continue;
+        int last = node->topCount < AUTOCOMPLETE_TOP_K ? node->topCount : AUTOCOMPLETE_TOP_K - 1;
+        memmove(&node->top[position + 1], &node->top[position], (last - position) * sizeof(int));
+        node->top[position] = i;
+        if (node->topCount < AUTOCOMPLETE_TOP_K) node->topCount++;
+    }
+
+    // A city ending exactly here sorts first and needs no child
+    int first = low;
+    if (first < high && cities[first].key[depth] == '\0') {
+        first++;
+    }
+
+    // Children: one per distinct next byte
+    int childCount = 0;
+    for (int i = first; i < high; i++) {
+        if (i == first || cities[i].key[depth] != cities[i - 1].key[depth]) childCount++;
+    }
+    node->firstChild = cityTrie.nodeCount;
+    node->childCount = childCount;
+    cityTrie.nodeCount += childCount;
+
+    int child = node->firstChild;
+    for (int start = first; start < high; child++) {
+        int end = start + 1;
+        while (end < high && cities[end].key[depth] == cities[start].key[depth]) end++;
+
+        // Sorted range: the common prefix of the group is the one of its first and last key
+        const char *a = cities[start].key, *b = cities[end - 1].key;
+        int common = depth;
+        while (a[common] != '\0' && a[common] == b[common]) common++;
+
+        TrieNode *childNode = &cityTrie.nodes[child];
+        childNode->city = start;
+        childNode->labelStart = depth;
+        childNode->labelLength = common - depth;
+        buildTrieNode(child, start, end, common);
+        start = end;
+    }
 }
 
-void saveFlightsToFile() {
-    FILE *file = fopen("flights.txt", "w");
-    if (!file) {
-        perror("Failed to open flights file for writing");
+void freeCityTrie() {
+    freeNameTrigrams();
+    for (int i = 0; i < cityTrie.cityCount; i++) {
+        free(cityTrie.cities[i].display);
+        free(cityTrie.cities[i].key);
+    }
+    free(cityTrie.cities);
+    free(cityTrie.nodes);
+    cityTrie.cities = NULL;
+    cityTrie.nodes = NULL;
+    cityTrie.cityCount = 0;
+    cityTrie.nodeCount = 0;
+    cityTrie.dirty = true;
+}
+
+// Collects every origin, destination and hotel location and builds the compressed trie over them
+void buildCityTrie() {
+    freeCityTrie();
+
+    StrIndex seen = {0};
+    int capacity = 0;
+    for (Flight *flight = flightsHead; flight != NULL; flight = flight->next) {
+        addCity(&seen, &cityTrie.cities, &cityTrie.cityCount, &capacity, symbolName(flight->origin));
+        addCity(&seen, &cityTrie.cities, &cityTrie.cityCount, &capacity, symbolName(flight->destination));
+    }
+    for (Hotel *hotel = hotelsHead; hotel != NULL; hotel = hotel->next) {
+        addCity(&seen, &cityTrie.cities, &cityTrie.cityCount, &capacity, symbolName(hotel->location));
+    }
+    strIndexClear(&seen);
+    if (cityTrie.cityCount > 0) {
+        qsort(cityTrie.cities, cityTrie.cityCount, sizeof(CityEntry), compareCityKeys);
+    }
+
+    // A radix trie has fewer than 2 nodes per key, plus the root
+    cityTrie.nodes = (TrieNode *)calloc(2 * cityTrie.cityCount + 1, sizeof(TrieNode));
+    if (cityTrie.nodes == NULL) {
+        perror("Failed to allocate memory for city autocomplete");
         return;
     }
-    Flight *current = flightsHead;
-    while (current != NULL) {
-        fprintf(file, "%d|%s|%s|%s|%s|%d\n",
-                current->flightNumber, current->origin, current->destination,
-                current->departureTime, current->arrivalTime, current->seatsAvailable);
-        current = current->next;
+    cityTrie.nodeCount = 1;
+    buildTrieNode(0, 0, cityTrie.cityCount, 0);
+    buildNameTrigrams();
+    cityTrie.dirty = false;
+}
+
+// Up to maxResults cities starting with prefix (case and accent insensitive), most used first; cost depends on the prefix only
+int autocompleteCity(const char *prefix, const char **results, int maxResults) {
+    if (cityTrie.dirty) {
+        buildCityTrie();
+        if (cityTrie.dirty) return 0;
+    }
+
+    char folded[TOKEN_MAX];
+    foldText(prefix, folded, sizeof(folded));
+    const TrieNode *node = &cityTrie.nodes[0];
+    const unsigned char *p = (const unsigned char *)folded;
+    while (*p) {
+        const TrieNode *next = NULL;
+        for (int c = 0; c < node->childCount; c++) {
+            const TrieNode *child = &cityTrie.nodes[node->firstChild + c];
+            if ((unsigned char)cityTrie.cities[child->city].key[child->labelStart] == *p) {
+                next = child;
+                break;
+            }
+        }
+        if (next == NULL) {
+            return 0;
+        }
+        const char *label = cityTrie.cities[next->city].key + next->labelStart;
+        for (int i = 0; i < next->labelLength && *p; i++, p++) {
+            if ((unsigned char)label[i] != *p) {
+                return 0;
+            }
+        }
+        node = next;
+    }
+
+    int count = node->topCount < maxResults ? node->topCount : maxResults;
+    for (int i = 0; i < count; i++) {
+        results[i] = cityTrie.cities[node->top[i]].display;
+    }
+    return count;
+}
+
+///////////////////////////////////////////////// REGISTER FUNCTION ADMIN OR USER ///////////////////////////////////////////////////////////////////////
+
+void registerUser() {
+    User *newUser = (User *)arenaAlloc(&userArena);
+    if (!newUser) {
+        perror("Memory allocation failed");
+        return;
+    }
+
+    printf("Enter username: ");
+    scanf("%49s", newUser->username);
+    clearInputBuffer();
+
+    printf("Enter password: ");
+    scanf("%49s", newUser->password);
+    clearInputBuffer();
+
+    printf("Is this an admin account? (1 for Yes, 0 for No): ");
+    scanf("%d", &newUser->isAdmin);
+    clearInputBuffer();
+
+    // Prevent memory leak by initializing the next pointer to NULL
+    newUser->next = NULL;
+    newUser->prev = usersTail;
+    newUser->userID = 0;
+
+    // Check if username already exists
+    if (findUser(newUser->username) != NULL) {
+        printf("This username already exists.\n");
+        arenaUnalloc(&userArena);
+        return;
+    }
+    if (!assignUserSlot(newUser)) {
+        arenaUnalloc(&userArena);
+        return;
+    }
+
+    // Insert at the end or as the first element
+    if (usersTail == NULL) { // No users yet, add as the first user
+        head = newUser;
+    } else {
+        usersTail->next = newUser; // Add new user at the end of the list
+    }
+    usersTail = newUser;
+    strIndexInsert(&userIndex, newUser->username, newUser);
+    saveUsers();
+    printf("User registered successfully!\n");
+}
+
+///////////////////////////////////////////////// LOGIN FUNCTION ADMIN OR USER ///////////////////////////////////////////////////////////////////////
+int loginUser(int expectedAdmin) {
+    char username[50];
+    char password[50];
+    printf("Enter username: ");
+    scanf("%49s", username);
+    clearInputBuffer();
+    printf("Enter password: ");
+    scanf("%49s", password);
+    clearInputBuffer();
+
+    User *current = findUser(username);
+    if (current != NULL && strcmp(current->password, password) == 0) {
+        if (current->isAdmin == expectedAdmin) {
+            strcpy(currentUser, username);  //GUARDAR CURRENT USER PRAS OUTRAS FUNÇOES ESPECIFICAS( funçoes que necessitam de user especificio)
+            return current->isAdmin;  // Returns 1 for admin, 0 for regular user
+        } else {
+            printf("Access denied. Incorrect user role.\n");
+            return -1;  // Wrong type of user for the intended operation
+        }
+    }
+
+    printf("Invalid username or password.\n");
+    return -1;
+}
+
+void logout() {
+    currentUser[0] = '\0';
+    printf("You have been logged out.\n");
+}
+
+
+//////////////////////////////////////////////// MAPPED FILES ////////////////////////////////////////////////////////////////////////
+
+// Maps the whole file read-only (private mapping, nothing is ever written through it); false if it cannot be opened.
+// Loading then costs one mapping instead of an fread per record, the pages come in as the records are decoded.
+bool mapFile(const char *path, MappedFile *file) {
+    memset(file, 0, sizeof(*file));
+#if defined(_WIN32)
+    HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        return false;
+    }
+    file->size = (size_t)size.QuadPart;
+    if (file->size > 0) {
+        file->mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+        file->data = file->mapping ? (const unsigned char *)MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    }
+    CloseHandle(handle); // The mapping keeps the file open
+    if (file->size > 0 && file->data == NULL) {
+        if (file->mapping) CloseHandle(file->mapping);
+        return false;
+    }
+#elif defined(HAVE_MMAP)
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        close(descriptor);
+        return false;
+    }
+    file->size = (size_t)info.st_size;
+    if (file->size > 0) {
+        void *data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED) {
+            close(descriptor);
+            return false;
+        }
+        posix_madvise(data, file->size, POSIX_MADV_SEQUENTIAL); // Records are decoded front to back
+        file->data = (const unsigned char *)data;
+    }
+    close(descriptor); // The mapping stays valid after close
+#else
+    FILE *handle = fopen(path, "rb");
+    if (handle == NULL) {
+        return false;
+    }
+    long size = fseek(handle, 0, SEEK_END) == 0 ? ftell(handle) : -1;
+    rewind(handle);
+    unsigned char *data = size > 0 ? (unsigned char *)malloc((size_t)size) : NULL;
+    if (size > 0 && (data == NULL || fread(data, (size_t)size, 1, handle) != 1)) {
+        free(data);
+        fclose(handle);
+        return false;
+    }
+    fclose(handle);
+    file->data = data;
+    file->size = size > 0 ? (size_t)size : 0;
+#endif
+    return true;
+}
+
+// Pointer to the next record of `size` bytes inside the mapping, NULL when fewer bytes are left.
+// Every layout has int-aligned sizes after an int-aligned header, so records can be read in place.
+const void *mappedNext(MappedFile *file, size_t size) {
+    if (file->size - file->offset < size) {
+        return NULL;
+    }
+    const void *record = file->data + file->offset;
+    file->offset += size;
+    return record;
+}
+
+// Must be called before the file is renamed or rewritten (Windows refuses while a view is open)
+void unmapFile(MappedFile *file) {
+#if defined(_WIN32)
+    if (file->data != NULL) {
+        UnmapViewOfFile(file->data);
+        CloseHandle(file->mapping);
+    }
+#elif defined(HAVE_MMAP)
+    if (file->data != NULL) {
+        munmap((void *)file->data, file->size);
+    }
+#else
+    free((void *)file->data);
+#endif
+    memset(file, 0, sizeof(*file));
+}
+
+// Name fields of a mapped record cannot be terminated in place, a copy is interned instead
+static Symbol internRecordName(const char *field, size_t size) {
+    char name[64];
+    size_t length = strnlen(field, size < sizeof(name) ? size : sizeof(name) - 1);
+    memcpy(name, field, length);
+    name[length] = '\0';
+    return internString(name);
+}
+
+//////////////////////////////////////////////// FILE HEADERS ////////////////////////////////////////////////////////////////////////
+
+static uint32_t fileHeaderChecksum(const FileHeader *header, uint32_t recordsCrc) {
+    return computeCrc32(recordsCrc, header, offsetof(FileHeader, checksum));
+}
+
+// The magic alone is not enough: a legacy users.dat starts with a username, and "USERxyz" matches it. A known
+// version must carry our record size; a newer one must at least account for the whole file
+static bool headerFieldsPlausible(const FileHeader *stored, size_t fileSize, size_t recordSize) {
+    if (stored->version >= 1 && stored->version <= FILE_FORMAT_VERSION) {
+        return stored->recordSize == recordSize;
+    }
+    return stored->version != 0 && stored->recordSize != 0
+        && fileSize == sizeof(FileHeader) + (size_t)stored->recordCount * stored->recordSize;
+}
+
+// Validates the header at the start of the mapping and leaves offset on the first record
+static HeaderCheck checkFileHeader(MappedFile *file, const char *name, const char *magic, size_t recordSize, FileHeader *header) {
+    const FileHeader *stored = (const FileHeader *)mappedNext(file, sizeof(FileHeader));
+    if (stored == NULL || memcmp(stored->magic, magic, 4) != 0 || !headerFieldsPlausible(stored, file->size, recordSize)) {
+        file->offset = 0;
+        return HEADER_MISSING;
+    }
+    *header = *stored;
+
+    const char *problem = NULL;
+    size_t records = file->size - file->offset;
+    if (header->version > FILE_FORMAT_VERSION) {
+        problem = "written by a newer version";
+    } else if (records != (size_t)header->recordCount * recordSize) {
+        problem = records < (size_t)header->recordCount * recordSize ? "truncated" : "unexpected data after the records";
+    } else if (header->checksum != fileHeaderChecksum(header, computeCrc32(0, file->data + file->offset, records))) {
+        problem = "checksum mismatch";
+    }
+    if (problem != NULL) {
+        printf("%s cannot be loaded (%s).\n", name, problem);
+        return HEADER_REJECTED;
+    }
+    return HEADER_OK;
+}
+
+// Keeps a rejected file as <name>.bad so the next save does not overwrite it
+static void setAsideRejectedFile(MappedFile *file, const char *name) {
+    char badName[64];
+    snprintf(badName, sizeof(badName), "%s.bad", name);
+    unmapFile(file);
+    remove(badName);
+    if (rename(name, badName) == 0) {
+        printf("It was moved to %s, starting without it.\n", badName);
+    } else {
+        perror("Failed to move the rejected file aside");
+    }
+}
+
+// Writes the header with a zero count; writeHeaderRecord and finishFileHeader fill in the count and checksum
+static bool beginFileHeader(FILE *file, FileHeader *header, const char *magic, size_t recordSize, uint32_t extra) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, magic, 4);
+    header->version = FILE_FORMAT_VERSION;
+    header->recordSize = (uint16_t)recordSize;
+    header->extra = extra;
+    return fwrite(header, sizeof(*header), 1, file) == 1;
+}
+
+static bool writeHeaderRecord(FILE *file, FileHeader *header, const void *record) {
+    header->recordCount++;
+    header->checksum = computeCrc32(header->checksum, record, header->recordSize); // Running CRC of the records so far
+    return fwrite(record, header->recordSize, 1, file) == 1;
+}
+
+static bool finishFileHeader(FILE *file, FileHeader *header) {
+    header->checksum = fileHeaderChecksum(header, header->checksum);
+    return fseek(file, 0, SEEK_SET) == 0 && fwrite(header, sizeof(*header), 1, file) == 1;
+}
+
+//////////////////////////////////////////////// TEXT FILE PARSER ////////////////////////////////////////////////////////////////////////
+
+bool lineReaderOpen(LineReader *reader, const char *path) {
+    memset(reader, 0, sizeof(*reader));
+    reader->file = fopen(path, "rb"); // Binary: '\r' of Windows line endings is stripped by lineReaderNext
+    if (reader->file == NULL) {
+        return false;
+    }
+    reader->capacity = LINE_READER_BLOCK;
+    reader->buffer = (char *)malloc(reader->capacity);
+    if (reader->buffer == NULL) {
+        fclose(reader->file);
+        reader->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Next line without its line ending, NULL at end of file. The pointer is valid until the next call
+char *lineReaderNext(LineReader *reader, size_t *length) {
+    while (1) {
+        char *line = reader->buffer + reader->start;
+        size_t available = reader->end - reader->start;
+        char *newline = (char *)memchr(line, '\n', available);
+        if (newline != NULL || (reader->atEnd && available > 0)) {
+            // The last line may have no '\n'; a byte is always kept free after end for its terminator
+            char *lineEnd = newline != NULL ? newline : reader->buffer + reader->end;
+            reader->start = (size_t)(lineEnd - reader->buffer) + (newline != NULL ? 1 : 0);
+            if (lineEnd > line && lineEnd[-1] == '\r') {
+                lineEnd--;
+            }
+            *lineEnd = '\0';
+            *length = (size_t)(lineEnd - line);
+            reader->lineNumber++;
+            return line;
+        }
+        if (reader->atEnd) {
+            return NULL;
+        }
+
+        // Keep the partial line, then fill the rest of the buffer with one large read
+        memmove(reader->buffer, line, available);
+        reader->start = 0;
+        reader->end = available;
+        if (reader->capacity - reader->end <= 1) {
+            char *grown = (char *)realloc(reader->buffer, reader->capacity * 2);
+            if (grown == NULL) {
+                perror("Failed to allocate memory for a long line");
+                reader->atEnd = true;
+                continue;
+            }
+            reader->buffer = grown;
+            reader->capacity *= 2;
+        }
+        size_t read = fread(reader->buffer + reader->end, 1, reader->capacity - reader->end - 1, reader->file);
+        reader->end += read;
+        if (read == 0) {
+            if (ferror(reader->file)) {
+                perror("Failed to read file");
+            }
+            reader->atEnd = true;
+        }
+    }
+}
+
+void lineReaderClose(LineReader *reader) {
+    if (reader->file != NULL) {
+        fclose(reader->file);
+    }
+    free(reader->buffer);
+    memset(reader, 0, sizeof(*reader));
+}
+
+// Cuts the line at each '|' in place; returns the number of fields, maxFields + 1 if there are more than maxFields
+int splitFields(char *line, size_t length, char **fields, int maxFields) {
+    char *end = line + length;
+    char *field = line;
+    int count = 0;
+    while (1) {
+        if (count == maxFields) {
+            return maxFields + 1;
+        }
+        fields[count++] = field;
+        char *separator = (char *)memchr(field, '|', (size_t)(end - field));
+        if (separator == NULL) {
+            return count;
+        }
+        *separator = '\0';
+        field = separator + 1;
+    }
+}
+
+// Whole field must be a number that fits in an int
+bool parseIntField(const char *text, int *value) {
+    char *end;
+    errno = 0;
+    long number = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || number < INT_MIN || number > INT_MAX) {
+        return false;
+    }
+    *value = (int)number;
+    return true;
+}
+
+// Text field that must fit in a buffer of `size` bytes; names are no longer cut short silently
+static bool textFieldFits(const char *text, size_t size) {
+    return text[0] != '\0' && strlen(text) < size;
+}
+
+//////////////////////////////////////////////// BINARY FOR USERS ////////////////////////////////////////////////////////////////////////
+
+static bool readUser(MappedFile *file, User *user, bool legacy) {
+    if (legacy) {
+        const LegacyUserRecord *record = (const LegacyUserRecord *)mappedNext(file, sizeof(LegacyUserRecord));
+        if (record == NULL) {
+            return false;
+        }
+        memcpy(user->username, record->username, sizeof(user->username));
+        memcpy(user->password, record->password, sizeof(user->password));
+        user->isAdmin = record->isAdmin;
+        user->userID = 0; // Numbered in file order, the same ids the old positional listing showed
+    } else {
+        const UserRecord *record = (const UserRecord *)mappedNext(file, sizeof(UserRecord));
+        if (record == NULL) {
+            return false;
+        }
+        memcpy(user->username, record->username, sizeof(user->username));
+        memcpy(user->password, record->password, sizeof(user->password));
+        user->isAdmin = record->isAdmin;
+        user->userID = record->userID;
+    }
+    user->username[sizeof(user->username) - 1] = '\0';
+    user->password[sizeof(user->password) - 1] = '\0';
+    return true;
+}
+
+void loadUsers() {
+    MappedFile file;
+    if (!mapFile("users.dat", &file)) {
+        printf("No existing user file found; starting new.\n");
+        return;
+    }
+
+    FileHeader header;
+    HeaderCheck check = checkFileHeader(&file, "users.dat", USERS_FILE_MAGIC, sizeof(UserRecord), &header);
+    if (check == HEADER_REJECTED) {
+        setAsideRejectedFile(&file, "users.dat");
+        return;
+    }
+
+    bool migrate = check == HEADER_MISSING;
+    bool legacy = false;
+    int nextID = 1;
+    size_t count;
+    if (!migrate) {
+        nextID = (int)header.extra;
+        count = header.recordCount;
+    } else {
+        const char *magic = (const char *)mappedNext(&file, 4);
+        const int *storedNextID = NULL;
+        legacy = magic == NULL || memcmp(magic, USERS_FILE_MAGIC_V2, 4) != 0;
+        if (legacy) {
+            file.offset = 0;
+        } else if ((storedNextID = (const int *)mappedNext(&file, sizeof(int))) != NULL) {
+            nextID = *storedNextID;
+        }
+        count = (file.size - file.offset) / (legacy ? sizeof(LegacyUserRecord) : sizeof(UserRecord));
+    }
+
+    User *current = NULL, *temp;
+    head = NULL;
+    arenaReserve(&userArena, count);
+
+    while (1) {
+        temp = (User *)arenaAlloc(&userArena);
+        if (temp == NULL) {
+            break;
+        }
+        if (!readUser(&file, temp, legacy)) {
+            arenaUnalloc(&userArena);
+            break;
+        }
+        if (temp->userID != 0 && (temp->userID < 0 || findUserByID(temp->userID) != NULL)) {
+            printf("User %s has an invalid or repeated ID %d, given a new one.\n", temp->username, temp->userID);
+            temp->userID = 0;
+        }
+        if (!assignUserSlot(temp)) {
+            arenaUnalloc(&userArena);
+            break;
+        }
+        temp->next = NULL;
+        temp->prev = current;
+
+        if (head == NULL) {
+            head = temp;
+            current = head;
+        } else {
+            current->next = temp;
+            current = temp;
+        }
+        usersTail = temp;
+        strIndexInsert(&userIndex, temp->username, temp);
+    }
+    unmapFile(&file);
+    if (nextID > userSlots.nextID) {
+        userSlots.nextID = nextID; // Ids of users deleted at the end of the list stay retired
+    }
+
+    // Same as reservations.dat: keep the old file and rewrite it in the new layout straight away
+    if (migrate && head != NULL) {
+        remove("users_legacy.bak");
+        if (rename("users.dat", "users_legacy.bak") == 0) {
+            saveUsers();
+            printf("users.dat migrated to the new format (backup in users_legacy.bak).\n");
+        } else {
+            perror("Failed to back up users.dat before migration");
+        }
+    }
+}
+void saveUsers() {
+    FILE *file = fopen("users.dat", "wb");
+    if (file == NULL) {
+        perror("Failed to open file for writing");
+        return;
+    }
+
+    FileHeader header;
+    bool written = beginFileHeader(file, &header, USERS_FILE_MAGIC, sizeof(UserRecord), (uint32_t)userSlots.nextID);
+    User *current = head;
+    while (written && current != NULL) {
+        // Zero-filled, the bytes after each string used to carry whatever was in memory
+        UserRecord record;
+        memset(&record, 0, sizeof(record));
+        record.userID = current->userID;
+        memcpy(record.username, current->username, strnlen(current->username, sizeof(record.username) - 1));
+        memcpy(record.password, current->password, strnlen(current->password, sizeof(record.password) - 1));
+        record.isAdmin = current->isAdmin;
+        written = writeHeaderRecord(file, &header, &record);
+        current = current->next;
+    }
+    written = written && finishFileHeader(file, &header);
+
+    if (fclose(file) != 0 || !written) {
+        perror("Failed to write users.dat");
+    }
+}
+
+void saveFlightsToFile() {
+    FILE *file = fopen("flights.txt", "w");
+    if (!file) {
+        perror("Failed to open flights file for writing");
+        return;
+    }
+    Flight *current = flightsHead;
+    while (current != NULL) {
+        fprintf(file, "%d|%s|%s|%s|%s|%d\n",
+                current->flightNumber, symbolName(current->origin), symbolName(current->destination),
+                current->departureTime, current->arrivalTime, current->seatsAvailable);
+        current = current->next;
+    }
+    fclose(file);
+}
+
+// flightNumber|origin|destination|departure|arrival|seats; a bad line is reported with its number and skipped
+void loadFlightsFromFile() {
+    LineReader reader;
+    if (!lineReaderOpen(&reader, "flights.txt")) {
+        perror("Failed to open flights file for reading");
+        return;
+    }
+    Flight *current = NULL;
+    int skipped = 0;
+    char *line;
+    size_t length;
+    while ((line = lineReaderNext(&reader, &length)) != NULL) {
+        if (length == 0) {
+            continue;
+        }
+        char *fields[6];
+        int flightNumber, seats;
+        const char *problem = NULL;
+        if (splitFields(line, length, fields, 6) != 6) {
+            problem = "expected 6 fields separated by '|'";
+        } else if (!parseIntField(fields[0], &flightNumber)) {
+            problem = "flight number is not a number";
+        } else if (!textFieldFits(fields[1], CITY_NAME_MAX) || !textFieldFits(fields[2], CITY_NAME_MAX)) {
+            problem = "origin and destination must be 1 to 49 characters";
+        } else if (!textFieldFits(fields[3], sizeof(current->departureTime)) || !textFieldFits(fields[4], sizeof(current->arrivalTime))) {
+            problem = "departure and arrival must be 1 to 19 characters";
+        } else if (!parseIntField(fields[5], &seats) || seats < 0) {
+            problem = "seats must be a number of 0 or more";
+        }
+        if (problem != NULL) {
+            printf("flights.txt:%ld: %s, line skipped.\n", reader.lineNumber, problem);
+            skipped++;
+            continue;
+        }
+
+        Flight *newFlight = (Flight *)arenaAlloc(&flightArena);
+        if (newFlight == NULL) {
+            break;
+        }
+        newFlight->flightNumber = flightNumber;
+        newFlight->origin = internString(fields[1]);
+        newFlight->destination = internString(fields[2]);
+        strcpy(newFlight->departureTime, fields[3]);
+        strcpy(newFlight->arrivalTime, fields[4]);
+        newFlight->seatsAvailable = seats;
+        parseFlightTimes(newFlight);
+        newFlight->next = NULL;
+        newFlight->prev = current;
+        if (flightsHead == NULL) {
+            flightsHead = newFlight;
+            current = flightsHead;
+        } else {
+            current->next = newFlight;
+            current = newFlight;
+        }
+        intIndexInsert(&flightIndex, newFlight->flightNumber, newFlight); // Duplicates keep the first one, like the old scan
+        routeIndexAdd(newFlight);
+    }
+    lineReaderClose(&reader);
+    if (skipped > 0) {
+        printf("flights.txt: %d line(s) skipped.\n", skipped);
+    }
+    buildFlightGraph(); // Adjacency is ready before the first connection search
+}
+
+void saveHotelsToFile() {
+    FILE *file = fopen("hotels.txt", "w");
+    if (!file) {
+        perror("Failed to open hotels file for writing");
+        return;
+    }
+    Hotel *current = hotelsHead;
+    while (current != NULL) {
+        fprintf(file, "%d|%s|%s|%d\n",
+                current->hotelID, current->name, symbolName(current->location), current->roomsAvailable);
+        current = current->next;
+    }
+    fclose(file);
+}
+
+// hotelID|name|location|rooms, same error handling as flights.txt
+void loadHotelsFromFile() {
+    LineReader reader;
+    if (!lineReaderOpen(&reader, "hotels.txt")) {
+        perror("Failed to open hotels file for reading");
+        return;
+    }
+    Hotel *current = NULL;
+    int skipped = 0;
+    char *line;
+    size_t length;
+    while ((line = lineReaderNext(&reader, &length)) != NULL) {
+        if (length == 0) {
+            continue;
+        }
+        char *fields[4];
+        int hotelID, rooms;
+        const char *problem = NULL;
+        if (splitFields(line, length, fields, 4) != 4) {
+            problem = "expected 4 fields separated by '|'";
+        } else if (!parseIntField(fields[0], &hotelID)) {
+            problem = "hotel ID is not a number";
+        } else if (!textFieldFits(fields[1], sizeof(current->name))) {
+            problem = "name must be 1 to 49 characters";
+        } else if (!textFieldFits(fields[2], LOCATION_MAX)) {
+            problem = "location must be 1 to 99 characters";
+        } else if (!parseIntField(fields[3], &rooms) || rooms < 0) {
+            problem = "rooms must be a number of 0 or more";
+        }
+        if (problem != NULL) {
+            printf("hotels.txt:%ld: %s, line skipped.\n", reader.lineNumber, problem);
+            skipped++;
+            continue;
+        }
+
+        Hotel *newHotel = (Hotel *)arenaAlloc(&hotelArena);
+        if (newHotel == NULL) {
+            break;
+        }
+        newHotel->hotelID = hotelID;
+        strcpy(newHotel->name, fields[1]);
+        newHotel->location = internString(fields[2]);
+        newHotel->roomsAvailable = rooms;
+        newHotel->next = NULL;
+        newHotel->prev = current;
+        if (hotelsHead == NULL) {
+            hotelsHead = newHotel;
+            current = hotelsHead;
+        } else {
+            current->next = newHotel;
+            current = newHotel;
+        }
+        intIndexInsert(&hotelIndex, newHotel->hotelID, newHotel); // Duplicates keep the first one, like the old scan
+        hotelTokenIndexAdd(newHotel);
+    }
+    lineReaderClose(&reader);
+    if (skipped > 0) {
+        printf("hotels.txt: %d line(s) skipped.\n", skipped);
+    }
+}
+
+// Zero-filled first so the padding and the end of the username never carry leftover memory into the file
+static void reservationToRecord(const Reservation *reservation, ReservationRecord *record) {
+    memset(record, 0, sizeof(*record));
+    record->reservationID = reservation->reservationID;
+    strncpy(record->username, symbolName(reservation->user), sizeof(record->username) - 1);
+    record->status = reservation->status;
+    record->flightNumber = reservation->flightNumber;
+    record->hotelID = reservation->hotelID;
+    record->startDay = reservation->startDay;
+    record->endDay = reservation->endDay;
+}
+
+static bool readReservation(MappedFile *file, Reservation *reservation) {
+    const ReservationRecord *record = (const ReservationRecord *)mappedNext(file, RESERVATION_RECORD_SIZE);
+    if (record == NULL) {
+        return false;
+    }
+    reservation->reservationID = record->reservationID;
+    reservation->user = internRecordName(record->username, sizeof(record->username));
+    reservation->status = record->status;
+    reservation->flightNumber = record->flightNumber;
+    reservation->hotelID = record->hotelID;
+    reservation->startDay = record->startDay;
+    reservation->endDay = record->endDay;
+    if (reservation->startDay < 0 || reservation->endDay <= reservation->startDay) {
+        reservation->startDay = reservation->endDay = NO_DATE;
+    }
+    return true;
+}
+
+// "RSV2" record, loaded as an undated reservation
+static bool readReservationV2(MappedFile *file, Reservation *reservation) {
+    const ReservationRecordV2 *record = (const ReservationRecordV2 *)mappedNext(file, sizeof(ReservationRecordV2));
+    if (record == NULL) {
+        return false;
+    }
+    reservation->reservationID = record->reservationID;
+    reservation->user = internRecordName(record->username, sizeof(record->username));
+    reservation->status = record->status;
+    reservation->flightNumber = record->flightNumber;
+    reservation->hotelID = record->hotelID;
+    reservation->startDay = reservation->endDay = NO_DATE;
+    return true;
+}
+
+// Checkpoint: writes every live reservation to reservations.dat and deletes the log segments it now contains.
+// New changes go to a fresh segment first, so a failed write leaves the old file and all segments usable.
+void saveReservationsToFile() {
+    unsigned covered = reservationLog.segment;
+    closeReservationLog();
+    reservationLog.segment = covered + 1;
+    reservationLog.bytes = 0;
+
+    FILE *file = fopen("reservations.tmp", "wb");
+    if (file == NULL) {
+        perror("Failed to open file for writing");
+        return;
+    }
+
+    FileHeader header;
+    bool written = beginFileHeader(file, &header, RESERVATIONS_FILE_MAGIC, RESERVATION_RECORD_SIZE, covered + 1);
+    Reservation *current = reservationsHead;
+    while (written && current != NULL) {
+        ReservationRecord record;
+        reservationToRecord(current, &record);
+        written = writeHeaderRecord(file, &header, &record);
+        current = current->next;
+    }
+    written = written && finishFileHeader(file, &header);
+    if (fclose(file) != 0 || !written) {
+        perror("Failed to write reservations snapshot");
+        remove("reservations.tmp");
+        return;
+    }
+
+    // rename does not replace an existing file on Windows
+    if (rename("reservations.tmp", "reservations.dat") != 0
+        && (remove("reservations.dat") != 0 || rename("reservations.tmp", "reservations.dat") != 0)) {
+        perror("Failed to replace reservations.dat");
+        return;
+    }
+
+    char name[64];
+    for (unsigned segment = reservationLog.firstSegment; segment <= covered; segment++) {
+        snprintf(name, sizeof(name), RESERVATION_LOG_PREFIX ".%u", segment);
+        remove(name);
+    }
+    remove(RESERVATION_LOG_PREFIX); // Single unnumbered log of older versions
+    reservationLog.firstSegment = covered + 1;
+}
+
+// Reads one record of the pre-enum layout into a Reservation; returns false at end of file
+static bool readLegacyReservation(MappedFile *file, Reservation *reservation) {
+    const LegacyReservationRecord *record = (const LegacyReservationRecord *)mappedNext(file, sizeof(LegacyReservationRecord));
+    if (record == NULL) {
+        return false;
+    }
+    char statusName[sizeof(record->status)];
+    memcpy(statusName, record->status, sizeof(statusName));
+    statusName[sizeof(statusName) - 1] = '\0';
+
+    int status = parseReservationStatus(statusName);
+    if (status < 0) {
+        printf("Reservation %d has unknown status '%s', marked as Rejected.\n", record->reservationID, statusName);
+        status = RES_REJECTED;
+    }
+    reservation->reservationID = record->reservationID;
+    reservation->user = internRecordName(record->username, sizeof(record->username));
+    reservation->status = (unsigned char)status;
+    reservation->flightNumber = record->flightNumber;
+    reservation->hotelID = record->hotelID;
+    reservation->startDay = reservation->endDay = NO_DATE;
+    return true;
+}
+
+// Reads every record of reservations.dat; false if the file was rejected. *migrate is set when it has an older
+// layout and must be rewritten
+static bool readReservationSnapshot(MappedFile *file, bool *migrate) {
+    FileHeader header;
+    HeaderCheck check = checkFileHeader(file, "reservations.dat", RESERVATIONS_FILE_MAGIC, RESERVATION_RECORD_SIZE, &header);
+    if (check == HEADER_REJECTED) {
+        // Only a hint (the header may be the damaged part), tells setAsideReservationLog where the segments start
+        if (header.extra > 0) {
+            reservationLog.firstSegment = header.extra;
+        }
+        return false;
+    }
+
+    bool version2 = false, legacy = false;
+    uint32_t nextSegment = 0;
+    size_t count;
+    *migrate = check == HEADER_MISSING;
+    if (!*migrate) {
+        nextSegment = header.extra;
+        count = header.recordCount;
+    } else {
+        const char *magic = (const char *)mappedNext(file, 4);
+        bool version4 = magic != NULL && memcmp(magic, RESERVATIONS_FILE_MAGIC_V4, 4) == 0;
+        version2 = magic != NULL && memcmp(magic, RESERVATIONS_FILE_MAGIC_V2, 4) == 0;
+        legacy = !version4 && !version2 && !(magic != NULL && memcmp(magic, RESERVATIONS_FILE_MAGIC_V3, 4) == 0);
+        if (legacy) {
+            file->offset = 0;
+        }
+        const uint32_t *storedSegment = version4 ? (const uint32_t *)mappedNext(file, sizeof(uint32_t)) : NULL;
+        if (storedSegment != NULL) {
+            nextSegment = *storedSegment;
+        }
+        size_t recordSize = legacy ? sizeof(LegacyReservationRecord) : version2 ? sizeof(ReservationRecordV2) : RESERVATION_RECORD_SIZE;
+        count = (file->size - file->offset) / recordSize;
+    }
+    if (nextSegment > 0) {
+        reservationLog.firstSegment = reservationLog.segment = nextSegment;
+    }
+
+    Reservation *current = NULL, *temp;
+    reservationsHead = NULL;
+    arenaReserve(&reservationArena, count);
+
+    while (1) {
+        temp = (Reservation *)arenaAlloc(&reservationArena);
+        if (temp == NULL) {
+            break;
+        }
+        bool read = legacy ? readLegacyReservation(file, temp)
+                  : version2 ? readReservationV2(file, temp)
+                  : readReservation(file, temp);
+        if (!read) {
+            arenaUnalloc(&reservationArena);
+            break;
+        }
+        if (temp->status >= RES_COUNT) {
+            printf("Reservation %d has an invalid status, marked as Rejected.\n", temp->reservationID);
+            temp->status = RES_REJECTED;
+        }
+        temp->next = NULL;
+
+        if (reservationsHead == NULL) {
+            reservationsHead = temp;
+            current = reservationsHead;
+        } else {
+            current->next = temp;
+            current = temp;
+        }
+        intIndexInsert(&reservationIndex, temp->reservationID, temp);
+        linkUserReservation(temp, false);
+        adjustOccupancy(temp, 1);
+        statusQueuePush(temp, true);
+        advanceReservationID(temp->reservationID);
+    }
+    return true;
+}
+
+void loadReservationsFromFile() {
+    bool migrate = false;
+    MappedFile file;
+    if (!mapFile("reservations.dat", &file)) {
+        printf("No reservation file found, starting new.\n");
+    } else if (!readReservationSnapshot(&file, &migrate)) {
+        setAsideRejectedFile(&file, "reservations.dat");
+        // The log only holds changes on top of that snapshot, replaying it alone would give a partial list
+        setAsideReservationLog();
+    } else {
+        unmapFile(&file);
+    }
+
+    // Changes made since the last checkpoint
+    bool logIntact = replayReservationLog();
+    // Only here, before any menu holds a Reservation pointer; reservations.dat drops them at the next checkpoint
+    purgeClosedReservations();
+
+    // Keep the old file around and rewrite it in the new layout straight away
+    if (migrate && reservationsHead != NULL) {
+        remove("reservations_legacy.bak");
+        if (rename("reservations.dat", "reservations_legacy.bak") == 0) {
+            saveReservationsToFile();
+            printf("reservations.dat migrated to the new format (backup in reservations_legacy.bak).\n");
+        } else {
+            perror("Failed to back up reservations.dat before migration");
+        }
+    } else if (!logIntact || reservationLog.bytes >= CHECKPOINT_LOG_BYTES) {
+        // New entries must not be appended after a damaged tail, fold what was read into reservations.dat
+        saveReservationsToFile();
+    }
+}
+
+// Links a new reservation in at the head of the list and into every index and counter
+void addReservation(Reservation *reservation) {
+    reservation->next = reservationsHead;
+    reservationsHead = reservation;
+    intIndexInsert(&reservationIndex, reservation->reservationID, reservation);
+    linkUserReservation(reservation, true);
+    adjustOccupancy(reservation, 1);
+    statusQueuePush(reservation, false);
+}
+
+int loadLastReservationID() {
+    FILE *file = fopen("last_id.txt", "r");
+    if (file == NULL) {
+        return 1000;  // COMEÇA NO 1000 ( IF U DELETE THIS FILE, U HAVE TO DELETE RESERVATION OR SET THE VALUE INSIDE TO THE OLD ID)
+    }
+    int lastID;
+    fscanf(file, "%d", &lastID);
+    fclose(file);
+    return lastID;
+}
+
+
+void saveLastReservationID(int lastID) {
+    FILE *file = fopen("last_id.txt", "w");
+    fprintf(file, "%d", lastID);
+    fclose(file);
+}
+////////////////////////////////////////////////////////// RESERVATION LOG //////////////////////////////////////////////////////////////
+
+// Standard CRC-32 (reflected, polynomial 0xEDB88320), table built on first use.
+// Start with crc = 0; pass the previous result to continue over more data.
+uint32_t computeCrc32(uint32_t crc, const void *data, size_t length) {
+    static uint32_t table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320u : 0);
+            }
+            table[i] = crc;
+        }
+        tableReady = true;
+    }
+
+    const unsigned char *bytes = (const unsigned char *)data;
+    crc ^= 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static uint32_t logRecordChecksum(const ReservationLogRecord *record) {
+    size_t offset = offsetof(ReservationLogRecord, type);
+    return computeCrc32(0, (const unsigned char *)record + offset, sizeof(*record) - offset);
+}
+
+// Zero-filled first so padding bytes are the same on write and on replay
+static void fillLogRecord(ReservationLogRecord *record, ReservationLogType type, const Reservation *reservation) {
+    memset(record, 0, sizeof(*record));
+    record->type = (unsigned char)type;
+    record->status = reservation->status;
+    record->reservationID = reservation->reservationID;
+    if (type == LOG_CREATE) {
+        record->flightNumber = reservation->flightNumber;
+        record->hotelID = reservation->hotelID;
+        record->startDay = reservation->startDay;
+        record->endDay = reservation->endDay;
+        strncpy(record->username, symbolName(reservation->user), sizeof(record->username) - 1);
+    }
+    record->checksum = logRecordChecksum(record);
+}
+
+// Renames one log file to <name>.bad; false if it does not exist (an older .bad is only replaced when it does)
+static bool setAsideLogFile(const char *name) {
+    FILE *probe = fopen(name, "rb");
+    if (probe == NULL) {
+        return false;
+    }
+    fclose(probe);
+    char badName[72];
+    snprintf(badName, sizeof(badName), "%s.bad", name);
+    remove(badName);
+    if (rename(name, badName) != 0) {
+        perror("Failed to move a log segment aside");
+        return false;
+    }
+    return true;
+}
+
+// One fwrite of a single record; a full segment (or a failed write) triggers a checkpoint
+static void appendReservationLog(const ReservationLogRecord *record) {
+    if (reservationLog.file == NULL) {
+        char name[64];
+        snprintf(name, sizeof(name), RESERVATION_LOG_PREFIX ".%u", reservationLog.segment);
+        if (reservationLog.bytes == 0) {
+            setAsideLogFile(name); // Left over from before a lost checkpoint, never replayed
+        }
+        reservationLog.file = fopen(name, "ab");
+    }
+    if (reservationLog.file != NULL && fwrite(record, sizeof(*record), 1, reservationLog.file) == 1
+        && fflush(reservationLog.file) == 0) {
+        reservationLog.bytes += (long)sizeof(*record);
+        if (reservationLog.bytes >= CHECKPOINT_LOG_BYTES) {
+            saveReservationsToFile();
+        }
+        return;
+    }
+    perror("Failed to write to the reservation log");
+    saveReservationsToFile();
+}
+
+void logReservationCreated(const Reservation *reservation) {
+    ReservationLogRecord record;
+    fillLogRecord(&record, LOG_CREATE, reservation);
+    appendReservationLog(&record);
+}
+
+void logReservationStatus(const Reservation *reservation) {
+    ReservationLogRecord record;
+    fillLogRecord(&record, LOG_STATUS, reservation);
+    appendReservationLog(&record);
+}
+
+// Applies one event; events already contained in reservations.dat change nothing
+static void applyLogRecord(const ReservationLogRecord *record) {
+    Reservation *reservation = findReservation(record->reservationID);
+    if (record->type == LOG_CREATE) {
+        if (reservation != NULL) {
+            return;
+        }
+        reservation = reservationPoolAcquire(&reservationPool);
+        if (reservation == NULL) {
+            perror("Failed to allocate memory for reservation");
+            return;
+        }
+        reservation->reservationID = record->reservationID;
+        reservation->user = internString(record->username);
+        reservation->flightNumber = record->flightNumber;
+        reservation->hotelID = record->hotelID;
+        reservation->startDay = record->startDay;
+        reservation->endDay = record->endDay;
+        reservation->status = record->status < RES_COUNT ? record->status : RES_REJECTED;
+        addReservation(reservation);
+        advanceReservationID(reservation->reservationID); // The next booking must not reuse a replayed ID
+    } else if (record->type == LOG_STATUS && reservation != NULL && record->status < RES_COUNT
+               && reservation->status != record->status) {
+        setReservationStatus(reservation, (ReservationStatus)record->status);
+    }
+}
+
+// Applies one log file; returns its size in bytes, or -1 if it does not exist. *intact turns false on a torn or corrupt record
+static long replayLogFile(const char *name, bool *intact) {
+    FILE *file = fopen(name, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    ReservationLogRecord record;
+    long applied = 0;
+    size_t read;
+    while ((read = fread(&record, 1, sizeof(record), file)) > 0) {
+        if (read != sizeof(record) || record.checksum != logRecordChecksum(&record)) {
+            printf("Damaged entry %ld in %s, ignoring it and everything after it.\n", applied + 1, name);
+            *intact = false;
+            break;
+        }
+        record.username[sizeof(record.username) - 1] = '\0';
+        applyLogRecord(&record);
+        applied++;
+    }
+
+    fclose(file);
+    return applied * (long)sizeof(record);
+}
+
+// Replays the segments after the checkpoint in order, over what loadReservationsFromFile read.
+// False if the log ends in a torn or corrupt record; new changes then need a checkpoint before they can be appended.
+bool replayReservationLog() {
+    bool intact = true;
+    if (replayLogFile(RESERVATION_LOG_PREFIX, &intact) >= 0) {
+        intact = false; // Unnumbered log of an older version, the next checkpoint removes it
+    }
+
+    char name[64];
+    for (unsigned segment = reservationLog.firstSegment; intact; segment++) {
+        snprintf(name, sizeof(name), RESERVATION_LOG_PREFIX ".%u", segment);
+        long bytes = replayLogFile(name, &intact);
+        if (bytes < 0) {
+            break;
+        }
+        // Keep appending to the last segment found
+        reservationLog.segment = segment;
+        reservationLog.bytes = bytes;
+    }
+    return intact;
+}
+
+// Moves every log segment aside and restarts numbering at 1, so nothing is replayed and new changes do not land
+// after stale records. Segments are looked for from 1 and from firstSegment upward, until one is missing.
+void setAsideReservationLog() {
+    char name[64];
+    int moved = setAsideLogFile(RESERVATION_LOG_PREFIX) ? 1 : 0;
+    unsigned segment = 1;
+    for (int pass = 0; pass < 2; pass++) {
+        for (;; segment++) {
+            snprintf(name, sizeof(name), RESERVATION_LOG_PREFIX ".%u", segment);
+            if (!setAsideLogFile(name)) {
+                break;
+            }
+            moved++;
+        }
+        if (reservationLog.firstSegment <= segment) {
+            break;
+        }
+        segment = reservationLog.firstSegment;
+    }
+    if (moved > 0) {
+        printf("%d reservation log file(s) moved aside with a .bad suffix.\n", moved);
+    }
+    reservationLog.firstSegment = reservationLog.segment = 1;
+    reservationLog.bytes = 0;
+}
+
+void closeReservationLog() {
+    if (reservationLog.file != NULL) {
+        fclose(reservationLog.file);
+        reservationLog.file = NULL;
+    }
+}
+
+////////////////////////////////////////////////////////// REPORT TO TXT //////////////////////////////////////////////////////////////
+
+void generateReservationsReport() {
+    FILE *file = fopen("reservations_report.txt", "w");
+    if (!file) {
+        perror("Failed to open file for writing");
+        return;
+    }
+
+    Reservation *current = reservationsHead;
+    if (current == NULL) {
+        fprintf(file, "No reservations available.\n");
+    } else {
+        fprintf(file, "Reservations Report:\n");
+        fprintf(file, "ID | User | Flight | Hotel | Status | Dates\n");
+        while (current != NULL) {
+            char dates[40];
+            formatReservationDates(current, dates, sizeof(dates));
+            fprintf(file, "%d | %s | %d | %d | %s | %s\n",
+                    current->reservationID,
+                    symbolName(current->user),
+                    current->flightNumber == -1 ? 0 : current->flightNumber,
+                    current->hotelID == -1 ? 0 : current->hotelID,
+                    statusNames[current->status],
+                    dates[0] ? dates + 1 : "-"); // Skip the leading space
+            current = current->next;
+        }
+    }
+
+    fclose(file);
+    printf("Reservations report generated successfully.\n");
+}
+
+
+////////////////////////////////////////////////////////// NOTIFICATIONS //////////////////////////////////////////////////////////////
+void recommendRandomFlight() {
+    if (flightsHead == NULL) {
+        printf("No flights available to recommend.\n");
+        return;
+    }
+
+    // Count the number of flights
+    int count = 0;
+    Flight *current = flightsHead;
+    while (current != NULL) {
+        count++;
+        current = current->next;
+    }
+
+    if (count == 0) {
+        printf("No flights available to recommend.\n");
+        return;
+    }
+
+    // Generate a random index for flight and phrase
+    srand(time(NULL)); // Seed the random number generator
+    int randomIndex = rand() % count;
+    int randomPhraseIndex = rand() % 3; // Assuming there are 3 phrases
+
+    // Traverse again to find the random flight
+    current = flightsHead;
+    for (int i = 0; i < randomIndex; i++) {
+        current = current->next;
+    }
+
+    // Array of phrases
+    const char *phrases[3] = {
+            "You should take a look at this flight: Flight %d from %s to %s. It's a super hot destination among our travelers!",
+            "Don't miss out on Flight %d from %s to %s. It's a top choice for out travel enthusiasts!",
+            "Explore the wonders of Flight %d by booking a trip from %s to %s. Adventure awaits!"
+    };
+
+    // Display the recommendation using a random phrase
+    printf(phrases[randomPhraseIndex],
+           current->flightNumber, symbolName(current->origin), symbolName(current->destination));
+}
+
+void displayAdminNotifications() {
+    printf("\n--- Administrative Notifications ---\n");
+    viewPendingReservations();  // Display all pending reservations
+    viewRequestCanceledReservations();  // Display all cancellation requests
+    printf("\n--- End of Notifications ---\n\n");
+}
+
+///////////////////////////////////////////////// RESERVATION HANDLING ///////////////////////////////////////////////////////////////////////
+
+// Asks for a date from today up to BOOKING_HORIZON_DAYS ahead; NO_DATE if the answer is not usable
+static int readTravelDate(const char *prompt) {
+    char input[32];
+    printf("%s", prompt);
+    if (fgets(input, sizeof(input), stdin) == NULL) {
+        return NO_DATE;
+    }
+    if (strchr(input, '\n') == NULL) {
+        clearInputBuffer();
+    }
+    input[strcspn(input, "\n")] = '\0';
+
+    int day = parseDate(input);
+    int today = currentDay();
+    if (day == NO_DATE) {
+        printf("Invalid date, use YYYY-MM-DD.\n");
+        return NO_DATE;
+    }
+    if (day < today || day > today + BOOKING_HORIZON_DAYS) {
+        printf("Date must be between today and %d days ahead.\n", BOOKING_HORIZON_DAYS);
+        return NO_DATE;
+    }
+    return day;
+}
+
+void makeFlightReservation(const char *username) {
+    int flightNumber;
+    printf("Enter flight number to reserve or type '0' to exit: ");
+    scanf("%d", &flightNumber);
+    clearInputBuffer();
+
+    if (flightNumber == 0) {
+        printf("Exiting reservation process.\n");
+        return;
+    }
+
+    if (findFlight(flightNumber) == NULL) {
+        printf("Flight not found.\n");
+        return;
+    }
+    int travelDay = readTravelDate("Enter travel date (YYYY-MM-DD): ");
+    if (travelDay == NO_DATE) {
+        return;
+    }
+
+    int availableSeats = calculateAvailableSeats(flightNumber, travelDay);
+    if (availableSeats <= 0) {
+        printf("Flight fully booked on that date.\n");
+        return;
+    }
+
+    Reservation *newReservation = reservationPoolAcquire(&reservationPool);
+    if (!newReservation) {
+        perror("Failed to allocate memory for reservation");
+        return;
+    }
+
+    newReservation->reservationID = generateReservationID();
+    newReservation->user = internString(username);
+    newReservation->flightNumber = flightNumber;
+    newReservation->hotelID = -1;
+    newReservation->startDay = travelDay;
+    newReservation->endDay = travelDay + 1;
+    newReservation->status = RES_PENDING;
+    addReservation(newReservation);
+
+    printf("Flight reservation made successfully! Reservation ID: %d\n", newReservation->reservationID);
+    logReservationCreated(newReservation);
+}
+
+
+void makeHotelReservation(const char *username) {
+    int hotelID;
+    printf("Enter hotel ID to reserve or type '0' to exit: ");
+    scanf("%d", &hotelID);
+    clearInputBuffer();
+
+    if (hotelID == 0) {
+        printf("Exiting reservation process.\n");
+        return;
+    }
+
+    if (findHotel(hotelID) == NULL) {
+        printf("Hotel not found.\n");
+        return;
+    }
+    int checkIn = readTravelDate("Enter check-in date (YYYY-MM-DD): ");
+    if (checkIn == NO_DATE) {
+        return;
+    }
+    int checkOut = readTravelDate("Enter check-out date (YYYY-MM-DD): ");
+    if (checkOut == NO_DATE) {
+        return;
+    }
+    if (checkOut <= checkIn || checkOut - checkIn > MAX_STAY_NIGHTS) {
+        printf("Check-out must be 1 to %d nights after check-in.\n", MAX_STAY_NIGHTS);
+        return;
+    }
+
+    int availableRooms = calculateAvailableRooms(hotelID, checkIn, checkOut);
+    if (availableRooms <= 0) {
+        printf("Hotel fully booked on some night of that stay.\n");
+        return;
+    }
+
+    Reservation *newReservation = reservationPoolAcquire(&reservationPool);
+    if (!newReservation) {
+        perror("Failed to allocate memory for reservation");
+        return;
+    }
+
+    newReservation->reservationID = generateReservationID();
+    newReservation->user = internString(username);
+    newReservation->flightNumber = -1;
+    newReservation->hotelID = hotelID;
+    newReservation->startDay = checkIn;
+    newReservation->endDay = checkOut;
+    newReservation->status = RES_PENDING;
+    addReservation(newReservation);
+
+    printf("Hotel reservation made successfully! Reservation ID: %d\n", newReservation->reservationID);
+    logReservationCreated(newReservation);
+}
+
+
+void listFlightsUser() {
+    Flight *current = flightsHead;
+    if (current == NULL) {
+        printf("No flights available.\n");
+        return;
+    }
+    while (current != NULL) {
+        printFlightAvailability(current);
+        current = current->next;
+    }
+}
+
+// Dated reservations only take seats on their own day, so the listing shows what is left on a day nobody booked yet
+void printFlightAvailability(const Flight *flight) {
+    Occupancy *occupancy = getOccupancy(&flightOccupancy, flight->flightNumber, false);
+    int availableSeats = flight->seatsAvailable - (occupancy ? occupancy->undated : 0);
+
+    if (availableSeats < 0) availableSeats = 0;  // Ensure we don't display negative numbers
+
+    printf("Flight %d: %s to %s, Departure: %s, Arrival: %s, Seats Available: %d per day\n",
+           flight->flightNumber, symbolName(flight->origin), symbolName(flight->destination),
+           flight->departureTime, flight->arrivalTime, availableSeats);
+}
+
+void listHotelsUser() {
+    Hotel *current = hotelsHead;
+    if (current == NULL) {
+        printf("No hotels available.\n");
+        return;
+    }
+    while (current != NULL) {
+        printHotelAvailability(current);
+        current = current->next;
+    }
+}
+
+void printHotelAvailability(const Hotel *hotel) {
+    Occupancy *occupancy = getOccupancy(&hotelOccupancy, hotel->hotelID, false);
+    int availableRooms = hotel->roomsAvailable - (occupancy ? occupancy->undated : 0);
+
+    if (availableRooms < 0) availableRooms = 0;  // Prevent negative numbers
+
+    printf("Hotel ID %d: %s, Location: %s, Rooms Available: %d per night\n",
+           hotel->hotelID, hotel->name, symbolName(hotel->location), availableRooms);
+}
+
+//USER VE AS PROPRIAS RESERVAS (RECEBE USER COMO PARAMETRO)
+void viewUserReservations(const char *username) {
+    UserReservations *list = getUserReservations(findSymbol(username), false);
+    Reservation *current = list ? list->head : NULL;
+    bool found = false;
+    printf("Reservations for %s:\n", username);
+    while (current != NULL) {
+        char dates[40];
+        formatReservationDates(current, dates, sizeof(dates));
+        printf("Reservation ID: %d, Flight: %d, Hotel: %d, Status: %s%s\n",
+               current->reservationID, current->flightNumber, current->hotelID, statusNames[current->status], dates);
+        found = true;
+        current = current->nextForUser;
+    }
+    if (!found) {
+        printf("No reservations found for this user.\n");
+    }
+}
+
+// USER PEDIR CANCELAMENTOS
+void cancelUserReservation(const char *username) {
+    int resID;
+    printf("Enter reservation ID to cancel or '0' to exit: ");
+    scanf("%d", &resID);
+    clearInputBuffer();
+
+    if (resID == 0) {
+        printf("Exiting...\n");
+        return; // Exits if user types '0'
+    }
+
+    Reservation *current = findReservation(resID);
+    if (current == NULL || current->user != findSymbol(username)) {
+        printf("Reservation not found.\n");
+        return;
+    }
+
+    if (setReservationStatus(current, RES_CANCEL_REQUESTED)) {
+        printf("Cancellation request submitted.\n");
+        logReservationStatus(current);
+    } else {
+        printf("Only approved reservations can be cancelled.\n");
+    }
+}
+
+// ADMIN ACEITAR RESERVAS
+void handleReservationApproval() {
+    int resID;
+    char decision[10];
+    printf("Enter reservation ID to approve or reject, or '0' to exit: ");
+    scanf("%d", &resID);
+    clearInputBuffer();
+
+    if (resID == 0) {
+        printf("Exiting...\n");
+        return; // Exits if user types '0'
+    }
+
+    Reservation *current = findReservation(resID);
+    if (current == NULL) {
+        printf("Reservation not found.\n");
+        return;
+    }
+    if (!canChangeStatus(current, RES_APPROVED) || !canChangeStatus(current, RES_REJECTED)) {
+        printf("Reservation is %s, only pending reservations can be approved or rejected.\n",
+               statusNames[current->status]);
+        return;
+    }
+
+    printf("Approve (yes) or Reject (no)? ");
+    scanf("%s", decision);
+    clearInputBuffer();
+
+    if (strcmp(decision, "yes") == 0) {
+        setReservationStatus(current, RES_APPROVED);
+        printf("Reservation approved.\n");
+    } else if (strcmp(decision, "no") == 0) {
+        setReservationStatus(current, RES_REJECTED);
+        printf("Reservation rejected.\n");
+    } else {
+        printf("Invalid input.\n");
+        return;
+    }
+    logReservationStatus(current);
+}
+
+// ADMIN ACEITAR OU NAO CANCELAMENTOS
+void handleCancellationRequests() {
+    int resID;
+    char decision[10];
+
+    printf("Enter reservation ID to process cancellation or '0' to exit: ");
+    scanf("%d", &resID);
+    clearInputBuffer();
+
+    if (resID == 0) {
+        printf("Exiting...\n");
+        return;
+    }
+
+    Reservation *current = findReservation(resID);
+
+    if (current == NULL) {
+        printf("Reservation not found.\n");
+        return;
+    }
+    if (!canChangeStatus(current, RES_CANCELLED)) {
+        printf("Reservation is %s, there is no cancellation request to process.\n",
+               statusNames[current->status]);
+        return;
+    }
+
+    printf("Confirm cancellation (yes/no) or type 'exit' to leave: ");
+    scanf("%9s", decision);
+    clearInputBuffer();
+
+    if (strcmp(decision, "exit") == 0) {
+        printf("Exiting without making changes.\n");
+        return; // Exits if user types 'exit'
+    }
+
+    if (strcmp(decision, "yes") == 0) {
+        setReservationStatus(current, RES_CANCELLED);
+        printf("Cancellation approved.\n");
+    } else if (strcmp(decision, "no") == 0) {
+        setReservationStatus(current, RES_APPROVED);
+        printf("Cancellation denied.\n");
+    } else {
+        printf("Invalid input. No changes made.\n");
+        return;
+    }
+    logReservationStatus(current);
+}
+
+//FUNÇAO DE LISTAR SEM FILTROS
+void viewAllReservations() {
+    printf("\nAll Reservations:\n");
+    if (reservationsHead == NULL) {
+        printf("No reservations available.\n");
+        return;
+    }
+
+    Reservation *current = reservationsHead;
+    while (current != NULL) {
+        printf("Reservation ID: %d, User: %s, ", current->reservationID, symbolName(current->user));
+        if (current->flightNumber != -1) {
+            printf("Flight Number: %d, ", current->flightNumber);
+        }
+        if (current->hotelID != -1) {
+            printf("Hotel ID: %d, ", current->hotelID);
+        }
+        char dates[40];
+        formatReservationDates(current, dates, sizeof(dates));
+        printf("Status: %s%s\n", statusNames[current->status], dates);
+        current = current->next;
+    }
+}
+
+//FUNÇAO DE LISTAR MAE QUE COMPARA AO STATUS FORNECIDO
+void listReservationsByStatus(ReservationStatus status) {
+    Reservation *current = statusQueues[status].head;
+    printf("\nReservations with status '%s':\n", statusNames[status]);
+    while (current != NULL) {
+        char dates[40];
+        formatReservationDates(current, dates, sizeof(dates));
+        printf("Reservation ID: %d, User: %s, Flight Number: %d, Hotel ID: %d%s\n",
+               current->reservationID, symbolName(current->user),
+               current->flightNumber, current->hotelID, dates);
+        current = current->nextInStatus;
+    }
+    if (statusQueues[status].count == 0) {
+        printf("No reservations found with status '%s'.\n", statusNames[status]);
+    }
+}
+//LISTAR PENDING
+void viewPendingReservations() {
+    listReservationsByStatus(RES_PENDING);
+}
+//LISTAR PEDIDOS DE CANCELAMENTO
+void viewRequestCanceledReservations() {
+    listReservationsByStatus(RES_CANCEL_REQUESTED);
+}
+//LISTAR ACEITES
+void viewAcceptedReservations() {
+    listReservationsByStatus(RES_APPROVED);
+} // se necessario
+
+//LISTAR CANCELADOS
+void viewCanceledReservations() {
+    listReservationsByStatus(RES_CANCELLED);
+} // se necessario
+
+//LISTAR REJEITADOS
+void viewrRejectedReservations() {
+    listReservationsByStatus(RES_REJECTED);
+} // se necessario
+////////////////////////////////////////////////////////// NO OVERBOOKING //////////////////////////////////////////////////////////////
+
+// Pending reservations hold their seat too, otherwise approving them could overbook the day
+int calculateAvailableSeats(int flightNumber, int day) {
+    Flight *flight = findFlight(flightNumber);
+    if (flight == NULL) return 0;
+    Occupancy *occupancy = getOccupancy(&flightOccupancy, flightNumber, false);
+    if (occupancy == NULL) return flight->seatsAvailable;
+    return flight->seatsAvailable - occupancy->undated - bookedOnDay(occupancy, day);
+}
+
+// Nights checkIn .. checkOut - 1 sit next to each other in booked[], the fullest one decides
+int calculateAvailableRooms(int hotelID, int checkIn, int checkOut) {
+    Hotel *hotel = findHotel(hotelID);
+    if (hotel == NULL) return 0;
+    Occupancy *occupancy = getOccupancy(&hotelOccupancy, hotelID, false);
+    if (occupancy == NULL) return hotel->roomsAvailable;
+
+    int fullest = 0;
+    int first = checkIn > occupancy->firstDay ? checkIn : occupancy->firstDay;
+    int last = checkOut < occupancy->firstDay + occupancy->dayCount ? checkOut : occupancy->firstDay + occupancy->dayCount;
+    for (int day = first; day < last; day++) {
+        int booked = occupancy->booked[day - occupancy->firstDay];
+        if (booked > fullest) fullest = booked;
+    }
+    return hotel->roomsAvailable - occupancy->undated - fullest;
+}
+
+////////////////////////////////////////////////////////// TRAVEL DATES //////////////////////////////////////////////////////////////
+
+// Day number of a proleptic Gregorian date, counting from 1970-01-01
+int daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; // Year starting in March
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static void civilFromDays(int days, int *year, int *month, int *day) {
+    days += 719468;
+    int era = (days >= 0 ? days : days - 146096) / 146097;
+    int dayOfEra = days - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthIndex = (5 * dayOfYear + 2) / 153;
+    *day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    *month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    *year = yearOfEra + era * 400 + (*month <= 2);
+}
+
+// YYYY-MM-DD to a day number; NO_DATE when malformed or not a real day (2025-02-30)
+int parseDate(const char *text) {
+    int year, month, day, length = 0;
+    if (sscanf(text, "%4d-%2d-%2d%n", &year, &month, &day, &length) != 3 || text[length] != '\0') {
+        return NO_DATE;
+    }
+    if (year < 1970 || month < 1 || month > 12 || day < 1 || day > 31) {
+        return NO_DATE;
+    }
+
+    int days = daysFromCivil(year, month, day);
+    int checkYear, checkMonth, checkDay;
+    civilFromDays(days, &checkYear, &checkMonth, &checkDay);
+    return checkMonth == month && checkDay == day ? days : NO_DATE;
+}
+
+void formatDate(int day, char *out, size_t size) {
+    int year, month, dayOfMonth;
+    civilFromDays(day, &year, &month, &dayOfMonth);
+    snprintf(out, size, "%04d-%02d-%02d", year, month, dayOfMonth);
+}
+
+int currentDay() {
+    return (int)(time(NULL) / 86400);
+}
+
+// " on <date>" for a flight, " from <check-in> to <check-out>" for a hotel, empty if undated
+void formatReservationDates(const Reservation *reservation, char *out, size_t size) {
+    if (reservation->startDay == NO_DATE) {
+        out[0] = '\0';
+        return;
+    }
+    char start[16], end[16];
+    formatDate(reservation->startDay, start, sizeof(start));
+    if (reservation->hotelID != -1) {
+        formatDate(reservation->endDay, end, sizeof(end));
+        snprintf(out, size, " from %s to %s", start, end);
+    } else {
+        snprintf(out, size, " on %s", start);
+    }
+}
+
+////////////////////////////////////////////////////////// HASH INDEXES //////////////////////////////////////////////////////////////
+
+#define INDEX_TOMBSTONE ((void *)&intIndexTombstone)
+#define INDEX_MIN_CAPACITY 16
+
+static const char intIndexTombstone = 0; // Only its address is used, marks deleted slots
+
+// MurmurHash3 finalizer: every key bit reaches the low bits that pick the slot, so sequential ids (1001, 1002...),
+// ids a power of two apart and packed trigram keys all spread across the whole table
+static size_t intIndexSlot(int key, size_t capacity) {
+    uint32_t hash = (uint32_t)key;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return (size_t)hash & (capacity - 1);
+}
+
+static bool intIndexResize(IntIndex *index, size_t newCapacity) {
+    int *oldKeys = index->keys;
+    void **oldValues = index->values;
+    size_t oldCapacity = index->capacity;
+
+    int *keys = (int *)malloc(newCapacity * sizeof(int));
+    void **values = (void **)calloc(newCapacity, sizeof(void *));
+    if (keys == NULL || values == NULL) {
+        free(keys);
+        free(values);
+        perror("Failed to allocate memory for index");
+        return false;
+    }
+
+    index->keys = keys;
+    index->values = values;
+    index->capacity = newCapacity;
+    index->count = 0;
+    index->used = 0;
+
+    // Re-insert only live entries, tombstones are dropped here
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldValues[i] != NULL && oldValues[i] != INDEX_TOMBSTONE) {
+            intIndexInsert(index, oldKeys[i], oldValues[i]);
+        }
+    }
+    free(oldKeys);
+    free(oldValues);
+    return true;
+}
+
+void *intIndexFind(const IntIndex *index, int key) {
+    if (index->capacity == 0) {
+        return NULL;
+    }
+    size_t slot = intIndexSlot(key, index->capacity);
+    while (index->values[slot] != NULL) {
+        if (index->values[slot] != INDEX_TOMBSTONE && index->keys[slot] == key) {
+            return index->values[slot];
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    return NULL;
+}
+
+// Returns false if the key is already indexed (the first record keeps the slot) or on allocation failure
+bool intIndexInsert(IntIndex *index, int key, void *value) {
+    // Keep the load factor (tombstones included) under 3/4 so probe chains stay short
+    if ((index->used + 1) * 4 > index->capacity * 3) {
+        size_t newCapacity = index->capacity ? index->capacity : INDEX_MIN_CAPACITY;
+        while ((index->count + 1) * 2 > newCapacity) {
+            newCapacity *= 2;
+        }
+        if (!intIndexResize(index, newCapacity)) {
+            return false;
+        }
+    }
+
+    size_t slot = intIndexSlot(key, index->capacity);
+    size_t firstFree = (size_t)-1;
+    while (index->values[slot] != NULL) {
+        if (index->values[slot] == INDEX_TOMBSTONE) {
+            if (firstFree == (size_t)-1) firstFree = slot;
+        } else if (index->keys[slot] == key) {
+            return false;
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+
+    if (firstFree != (size_t)-1) {
+        slot = firstFree; // Reuse a tombstone, "used" does not change
+    } else {
+        index->used++;
+    }
+    index->keys[slot] = key;
+    index->values[slot] = value;
+    index->count++;
+    return true;
+}
+
+void intIndexRemove(IntIndex *index, int key) {
+    if (index->capacity == 0) {
+        return;
+    }
+    size_t slot = intIndexSlot(key, index->capacity);
+    while (index->values[slot] != NULL) {
+        if (index->values[slot] != INDEX_TOMBSTONE && index->keys[slot] == key) {
+            index->values[slot] = INDEX_TOMBSTONE;
+            index->count--;
+            return;
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+}
+
+void intIndexClear(IntIndex *index) {
+    free(index->keys);
+    free(index->values);
+    index->keys = NULL;
+    index->values = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    index->used = 0;
+}
+
+Flight *findFlight(int flightNumber) {
+    return (Flight *)intIndexFind(&flightIndex, flightNumber);
+}
+
+Hotel *findHotel(int hotelID) {
+    return (Hotel *)intIndexFind(&hotelIndex, hotelID);
+}
+
+// FNV-1a, good enough for short keys like usernames
+static unsigned int strIndexHash(const char *key) {
+    unsigned int hash = 2166136261u;
+    while (*key) {
+        hash ^= (unsigned char)*key++;
+        hash *= 16777619u;
     }
-    fclose(file);
+    return hash;
 }
 
-void loadFlightsFromFile() {
-    FILE *file = fopen("flights.txt", "r");
-    if (!file) {
-        perror("Failed to open flights file for reading");
-        return;
+static bool strIndexResize(StrIndex *index, size_t newCapacity) {
+    const char **oldKeys = index->keys;
+    unsigned int *oldHashes = index->hashes;
+    void **oldValues = index->values;
+    size_t oldCapacity = index->capacity;
+
+    const char **keys = (const char **)malloc(newCapacity * sizeof(const char *));
+    unsigned int *hashes = (unsigned int *)malloc(newCapacity * sizeof(unsigned int));
+    void **values = (void **)calloc(newCapacity, sizeof(void *));
+    if (keys == NULL || hashes == NULL || values == NULL) {
+        free(keys);
+        free(hashes);
+        free(values);
+        perror("Failed to allocate memory for index");
+        return false;
     }
-    Flight *current = NULL;
-    while (!feof(file)) {
-        Flight *newFlight = (Flight *)malloc(sizeof(Flight));
-        if (fscanf(file, "%d|%49[^|]|%49[^|]|%19[^|]|%19[^|]|%d\n",
-                   &newFlight->flightNumber, newFlight->origin, newFlight->destination,
-                   newFlight->departureTime, newFlight->arrivalTime, &newFlight->seatsAvailable) == 6) {
-            newFlight->next = NULL;
-            if (flightsHead == NULL) {
-                flightsHead = newFlight;
-                current = flightsHead;
-            } else {
-                current->next = newFlight;
-                current = newFlight;
+
+    index->keys = keys;
+    index->hashes = hashes;
+    index->values = values;
+    index->capacity = newCapacity;
+    index->count = 0;
+    index->used = 0;
+
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldValues[i] != NULL && oldValues[i] != INDEX_TOMBSTONE) {
+            size_t slot = oldHashes[i] & (newCapacity - 1);
+            while (values[slot] != NULL) {
+                slot = (slot + 1) & (newCapacity - 1);
             }
-        } else {
-            free(newFlight);
-            break;
+            keys[slot] = oldKeys[i];
+            hashes[slot] = oldHashes[i];
+            values[slot] = oldValues[i];
+            index->count++;
+            index->used++;
         }
     }
-    fclose(file);
+    free(oldKeys);
+    free(oldHashes);
+    free(oldValues);
+    return true;
 }
 
-void saveHotelsToFile() {
-    FILE *file = fopen("hotels.txt", "w");
-    if (!file) {
-        perror("Failed to open hotels file for writing");
-        return;
+void *strIndexFind(const StrIndex *index, const char *key) {
+    if (index->capacity == 0) {
+        return NULL;
     }
-    Hotel *current = hotelsHead;
-    while (current != NULL) {
-        fprintf(file, "%d|%s|%s|%d\n",
-                current->hotelID, current->name, current->location, current->roomsAvailable);
-        current = current->next;
+    unsigned int hash = strIndexHash(key);
+    size_t slot = hash & (index->capacity - 1);
+    while (index->values[slot] != NULL) {
+        if (index->values[slot] != INDEX_TOMBSTONE && index->hashes[slot] == hash &&
+            strcmp(index->keys[slot], key) == 0) {
+            return index->values[slot];
+        }
+        slot = (slot + 1) & (index->capacity - 1);
     }
-    fclose(file);
+    return NULL;
 }
 
-void loadHotelsFromFile() {
-    FILE *file = fopen("hotels.txt", "r");
-    if (!file) {
-        perror("Failed to open hotels file for reading");
-        return;
-    }
-    Hotel *current = NULL;
-    while (!feof(file)) {
-        Hotel *newHotel = (Hotel *)malloc(sizeof(Hotel));
-        if (fscanf(file, "%d|%49[^|]|%99[^|]|%d\n",
-                   &newHotel->hotelID, newHotel->name, newHotel->location, &newHotel->roomsAvailable) == 4) {
-            newHotel->next = NULL;
-            if (hotelsHead == NULL) {
-                hotelsHead = newHotel;
-                current = hotelsHead;
-            } else {
-                current->next = newHotel;
-                current = newHotel;
-            }
-        } else {
-            free(newHotel);
-            break;
+// Returns false if the key is already indexed or on allocation failure
+bool strIndexInsert(StrIndex *index, const char *key, void *value) {
+    if ((index->used + 1) * 4 > index->capacity * 3) {
+        size_t newCapacity = index->capacity ? index->capacity : INDEX_MIN_CAPACITY;
+        while ((index->count + 1) * 2 > newCapacity) {
+            newCapacity *= 2;
+        }
+        if (!strIndexResize(index, newCapacity)) {
+            return false;
         }
     }
-    fclose(file);
-}
 
-void saveReservationsToFile() {
-    FILE *file = fopen("reservations.dat", "wb");
-    if (file == NULL) {
-        perror("Failed to open file for writing");
-        return;
+    unsigned int hash = strIndexHash(key);
+    size_t slot = hash & (index->capacity - 1);
+    size_t firstFree = (size_t)-1;
+    while (index->values[slot] != NULL) {
+        if (index->values[slot] == INDEX_TOMBSTONE) {
+            if (firstFree == (size_t)-1) firstFree = slot;
+        } else if (index->hashes[slot] == hash && strcmp(index->keys[slot], key) == 0) {
+            return false;
+        }
+        slot = (slot + 1) & (index->capacity - 1);
     }
 
-    Reservation *current = reservationsHead;
-    while (current != NULL) {
-        fwrite(current, sizeof(Reservation) - sizeof(Reservation*), 1, file);
-        current = current->next;
+    if (firstFree != (size_t)-1) {
+        slot = firstFree;
+    } else {
+        index->used++;
     }
-
-    fclose(file);
+    index->keys[slot] = key;
+    index->hashes[slot] = hash;
+    index->values[slot] = value;
+    index->count++;
+    return true;
 }
 
-void loadReservationsFromFile() {
-    FILE *file = fopen("reservations.dat", "rb");
-    if (file == NULL) {
-        printf("No reservation file found, starting new.\n");
+void strIndexRemove(StrIndex *index, const char *key) {
+    if (index->capacity == 0) {
         return;
     }
+    unsigned int hash = strIndexHash(key);
+    size_t slot = hash & (index->capacity - 1);
+    while (index->values[slot] != NULL) {
+        if (index->values[slot] != INDEX_TOMBSTONE && index->hashes[slot] == hash &&
+            strcmp(index->keys[slot], key) == 0) {
+            index->values[slot] = INDEX_TOMBSTONE;
+            index->count--;
+            return;
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+}
 
-    Reservation *current = NULL, *temp;
-    reservationsHead = NULL;
+void strIndexClear(StrIndex *index) {
+    free(index->keys);
+    free(index->hashes);
+    free(index->values);
+    index->keys = NULL;
+    index->hashes = NULL;
+    index->values = NULL;
+    index->capacity = 0;
+    index->count = 0;
+    index->used = 0;
+}
 
-    while (1) {
-        temp = (Reservation *)malloc(sizeof(Reservation));
-        if (fread(temp, sizeof(Reservation) - sizeof(Reservation*), 1, file) != 1) {
-            free(temp);
-            break;
-        }
-        temp->next = NULL;
+User *findUser(const char *username) {
+    return (User *)strIndexFind(&userIndex, username);
+}
 
-        if (reservationsHead == NULL) {
-            reservationsHead = temp;
-            current = reservationsHead;
-        } else {
-            current->next = temp;
-            current = temp;
-        }
+// O(1): ids index userSlots directly; NULL for unknown and deleted ids
+User *findUserByID(int userID) {
+    if (userID <= 0 || userID >= userSlots.capacity) {
+        return NULL;
     }
-
-    fclose(file);
+    return userSlots.slots[userID];
 }
 
-int loadLastReservationID() {
-    FILE *file = fopen("last_id.txt", "r");
-    if (file == NULL) {
-        return 1000;  // COMEÇA NO 1000 ( IF U DELETE THIS FILE, U HAVE TO DELETE RESERVATION OR SET THE VALUE INSIDE TO THE OLD ID)
+// A user with userID 0 gets the next free id; a loaded one keeps its own
+bool assignUserSlot(User *user) {
+    if (user->userID == 0) {
+        user->userID = userSlots.nextID;
     }
-    int lastID;
-    fscanf(file, "%d", &lastID);
-    fclose(file);
-    return lastID;
+    if (user->userID >= userSlots.capacity) {
+        int capacity = userSlots.capacity ? userSlots.capacity : 64;
+        while (capacity <= user->userID) capacity *= 2;
+        User **slots = (User **)realloc(userSlots.slots, capacity * sizeof(User *));
+        if (slots == NULL) {
+            perror("Failed to allocate memory for user ids");
+            return false;
+        }
+        memset(slots + userSlots.capacity, 0, (capacity - userSlots.capacity) * sizeof(User *));
+        userSlots.slots = slots;
+        userSlots.capacity = capacity;
+    }
+    userSlots.slots[user->userID] = user;
+    if (user->userID >= userSlots.nextID) {
+        userSlots.nextID = user->userID + 1;
+    }
+    return true;
 }
 
+Reservation *findReservation(int reservationID) {
+    return (Reservation *)intIndexFind(&reservationIndex, reservationID);
+}
 
-void saveLastReservationID(int lastID) {
-    FILE *file = fopen("last_id.txt", "w");
-    fprintf(file, "%d", lastID);
-    fclose(file);
+// Reservations may outlive their user (deleteUser), so the lists are keyed by username and not hung off User
+UserReservations *getUserReservations(Symbol user, bool create) {
+    UserReservations *list = (UserReservations *)intIndexFind(&userReservationsIndex, (int)user);
+    if (list != NULL || !create || user == 0) {
+        return list;
+    }
+
+    list = (UserReservations *)malloc(sizeof(UserReservations));
+    if (list == NULL) {
+        perror("Failed to allocate memory for user reservations");
+        return NULL;
+    }
+    list->user = user;
+    list->head = NULL;
+    list->tail = NULL;
+    intIndexInsert(&userReservationsIndex, (int)user, list);
+    return list;
 }
-////////////////////////////////////////////////////////// REPORT TO TXT //////////////////////////////////////////////////////////////
 
-void generateReservationsReport() {
-    FILE *file = fopen("reservations_report.txt", "w");
-    if (!file) {
-        perror("Failed to open file for writing");
+// atHead mirrors how the reservation went into reservationsHead (new bookings at the head, file loads at the tail)
+void linkUserReservation(Reservation *reservation, bool atHead) {
+    reservation->nextForUser = NULL;
+    UserReservations *list = getUserReservations(reservation->user, true);
+    if (list == NULL) {
         return;
     }
 
-    Reservation *current = reservationsHead;
-    if (current == NULL) {
-        fprintf(file, "No reservations available.\n");
+    if (list->head == NULL) {
+        list->head = reservation;
+        list->tail = reservation;
+    } else if (atHead) {
+        reservation->nextForUser = list->head;
+        list->head = reservation;
     } else {
-        fprintf(file, "Reservations Report:\n");
-        fprintf(file, "ID | User | Flight | Hotel | Status\n");
-        while (current != NULL) {
-            fprintf(file, "%d | %s | %d | %d | %s\n",
-                    current->reservationID,
-                    current->username,
-                    current->flightNumber == -1 ? 0 : current->flightNumber,
-                    current->hotelID == -1 ? 0 : current->hotelID,
-                    current->status);
-            current = current->next;
-        }
+        list->tail->nextForUser = reservation;
+        list->tail = reservation;
     }
-
-    fclose(file);
-    printf("Reservations report generated successfully.\n");
 }
 
-
-////////////////////////////////////////////////////////// NOTIFICATIONS //////////////////////////////////////////////////////////////
-void recommendRandomFlight() {
-    if (flightsHead == NULL) {
-        printf("No flights available to recommend.\n");
-        return;
+// Rejected and cancelled reservations more than CLOSED_HISTORY_DAYS past their last day leave the history: out of the
+// list and every index, and their nodes go back to reservationPool for the next bookings. Undated ones are kept.
+int purgeClosedReservations() {
+    int cutoff = currentDay() - CLOSED_HISTORY_DAYS;
+    int purged = 0;
+    Reservation **link = &reservationsHead;
+    while (*link != NULL) {
+        Reservation *reservation = *link;
+        bool closed = reservation->status == RES_REJECTED || reservation->status == RES_CANCELLED;
+        if (!closed || reservation->startDay == NO_DATE || reservation->endDay > cutoff) {
+            link = &reservation->next;
+            continue;
+        }
+        *link = reservation->next;
+        intIndexRemove(&reservationIndex, reservation->reservationID);
+        statusQueueRemove(reservation); // Closed reservations hold no occupancy
+        purged++;
+        if (getUserReservations(reservation->user, false) == NULL) {
+            reservationPoolRelease(&reservationPool, reservation); // In no per-user list
+        } else {
+            reservation->status = RES_COUNT; // Marks it for the per-user pass below
+        }
     }
-
-    // Count the number of flights
-    int count = 0;
-    Flight *current = flightsHead;
-    while (current != NULL) {
-        count++;
-        current = current->next;
+    if (purged == 0) {
+        return 0;
     }
 
-    if (count == 0) {
-        printf("No flights available to recommend.\n");
-        return;
+    // One pass over every per-user list, so the cost stays O(reservations) however many a user loses
+    for (size_t slot = 0; slot < userReservationsIndex.capacity; slot++) {
+        UserReservations *list = (UserReservations *)userReservationsIndex.values[slot];
+        if (list == NULL || list == INDEX_TOMBSTONE) {
+            continue;
+        }
+        Reservation *previous = NULL;
+        Reservation *current = list->head;
+        while (current != NULL) {
+            Reservation *next = current->nextForUser;
+            if (current->status == RES_COUNT) {
+                if (previous != NULL) previous->nextForUser = next;
+                else list->head = next;
+                reservationPoolRelease(&reservationPool, current);
+            } else {
+                previous = current;
+            }
+            current = next;
+        }
+        list->tail = previous;
     }
+    return purged;
+}
 
-    // Generate a random index for flight and phrase
-    srand(time(NULL)); // Seed the random number generator
-    int randomIndex = rand() % count;
-    int randomPhraseIndex = rand() % 3; // Assuming there are 3 phrases
+////////////////////////////////////////////////////////// STRING INTERNING //////////////////////////////////////////////////////////////
 
-    // Traverse again to find the random flight
-    current = flightsHead;
-    for (int i = 0; i < randomIndex; i++) {
-        current = current->next;
+Symbol findSymbol(const char *text) {
+    return (Symbol)(uintptr_t)strIndexFind(&symbols.lookup, text);
+}
+
+// Symbol of text, storing it the first time it is seen; 0 only if memory runs out
+Symbol internString(const char *text) {
+    Symbol symbol = findSymbol(text);
+    if (symbol != 0) {
+        return symbol;
     }
 
-    // Array of phrases
-    const char *phrases[3] = {
-            "You should take a look at this flight: Flight %d from %s to %s. It's a super hot destination among our travelers!",
-            "Don't miss out on Flight %d from %s to %s. It's a top choice for out travel enthusiasts!",
-            "Explore the wonders of Flight %d by booking a trip from %s to %s. Adventure awaits!"
-    };
+    size_t length = strlen(text) + 1;
+    SymbolBlock *block = symbols.blocks;
+    if (block == NULL || block->capacity - block->used < length) {
+        size_t capacity = length > SYMBOL_BLOCK_SIZE ? length : SYMBOL_BLOCK_SIZE;
+        block = (SymbolBlock *)malloc(sizeof(SymbolBlock) + capacity);
+        if (block == NULL) {
+            perror("Failed to allocate memory for symbols");
+            return 0;
+        }
+        block->used = 0;
+        block->capacity = capacity;
+        block->next = symbols.blocks;
+        symbols.blocks = block;
+    }
+    if (symbols.count + 1 >= symbols.capacity) {
+        uint32_t capacity = symbols.capacity ? symbols.capacity * 2 : 256;
+        const char **names = (const char **)realloc(symbols.names, capacity * sizeof(const char *));
+        if (names == NULL) {
+            perror("Failed to allocate memory for symbols");
+            return 0;
+        }
+        names[0] = "";
+        symbols.names = names;
+        symbols.capacity = capacity;
+    }
 
-    // Display the recommendation using a random phrase
-    printf(phrases[randomPhraseIndex],
-           current->flightNumber, current->origin, current->destination);
+    char *copy = block->text + block->used;
+    memcpy(copy, text, length);
+    block->used += length;
+    symbol = ++symbols.count;
+    symbols.names[symbol] = copy;
+    strIndexInsert(&symbols.lookup, copy, (void *)(uintptr_t)symbol);
+    return symbol;
 }
 
-void displayAdminNotifications() {
-    printf("\n--- Administrative Notifications ---\n");
-    viewPendingReservations();  // Display all pending reservations
-    viewRequestCanceledReservations();  // Display all cancellation requests
-    printf("\n--- End of Notifications ---\n\n");
+const char *symbolName(Symbol symbol) {
+    return symbol != 0 && symbol <= symbols.count ? symbols.names[symbol] : "";
 }
 
-///////////////////////////////////////////////// RESERVATION HANDLING ///////////////////////////////////////////////////////////////////////
-
-void makeFlightReservation(const char *username) {
-    int flightNumber;
-    printf("Enter flight number to reserve or type '0' to exit: ");
-    scanf("%d", &flightNumber);
-    clearInputBuffer();
+////////////////////////////////////////////////////////// OCCUPANCY COUNTERS //////////////////////////////////////////////////////////////
 
-    if (flightNumber == 0) {
-        printf("Exiting reservation process.\n");
-        return;
+// Keyed by number and not stored in Flight/Hotel, so counts survive a flight being deleted and added again
+Occupancy *getOccupancy(IntIndex *index, int key, bool create) {
+    Occupancy *occupancy = (Occupancy *)intIndexFind(index, key);
+    if (occupancy != NULL || !create) {
+        return occupancy;
     }
 
-    int availableSeats = calculateAvailableSeats(flightNumber);
-    if (availableSeats <= 0) {
-        printf("Flight fully booked or no seats available.\n");
-        return;
+    occupancy = (Occupancy *)calloc(1, sizeof(Occupancy));
+    if (occupancy == NULL) {
+        perror("Failed to allocate memory for occupancy");
+        return NULL;
     }
+    intIndexInsert(index, key, occupancy);
+    return occupancy;
+}
 
-    Reservation *newReservation = (Reservation *)malloc(sizeof(Reservation));
-    if (!newReservation) {
-        perror("Failed to allocate memory for reservation");
-        return;
+// Grows booked[] so it covers days start .. end - 1, at least doubling so a run of later dates does not realloc each time
+static bool occupancyCoverDays(Occupancy *occupancy, int start, int end) {
+    int oldEnd = occupancy->firstDay + occupancy->dayCount;
+    if (occupancy->booked != NULL && start >= occupancy->firstDay && end <= oldEnd) {
+        return true;
     }
 
-    newReservation->reservationID = generateReservationID();
-    strcpy(newReservation->username, username);
-    newReservation->flightNumber = flightNumber;
-    newReservation->hotelID = -1;
-    strcpy(newReservation->status, "Pending");
-    newReservation->next = reservationsHead;
-    reservationsHead = newReservation;
-
-    printf("Flight reservation made successfully! Reservation ID: %d\n", newReservation->reservationID);
-    saveReservationsToFile();
+    int first = start, last = end;
+    if (occupancy->booked != NULL) {
+        if (occupancy->firstDay < first) first = occupancy->firstDay;
+        if (oldEnd > last) last = oldEnd;
+    }
+    int capacity = last - first;
+    if (capacity < 2 * occupancy->dayCount) capacity = 2 * occupancy->dayCount;
+    if (capacity < 32) capacity = 32;
+    // The spare days go on the side that grew
+    int newFirst = occupancy->booked != NULL && start < occupancy->firstDay ? last - capacity : first;
+
+    int *booked = (int *)calloc((size_t)capacity, sizeof(int));
+    if (booked == NULL) {
+        perror("Failed to allocate memory for daily occupancy");
+        return false;
+    }
+    if (occupancy->booked != NULL) {
+        memcpy(booked + (occupancy->firstDay - newFirst), occupancy->booked, (size_t)occupancy->dayCount * sizeof(int));
+        free(occupancy->booked);
+    }
+    occupancy->booked = booked;
+    occupancy->firstDay = newFirst;
+    occupancy->dayCount = capacity;
+    return true;
 }
 
+// Dated pending/approved reservations holding the day, undated ones not included
+int bookedOnDay(const Occupancy *occupancy, int day) {
+    int offset = day - occupancy->firstDay;
+    return occupancy->booked != NULL && offset >= 0 && offset < occupancy->dayCount ? occupancy->booked[offset] : 0;
+}
 
-void makeHotelReservation(const char *username) {
-    int hotelID;
-    printf("Enter hotel ID to reserve or type '0' to exit: ");
-    scanf("%d", &hotelID);
-    clearInputBuffer();
-
-    if (hotelID == 0) {
-        printf("Exiting reservation process.\n");
+// Adds (delta = 1) or removes (delta = -1) a reservation from the counters of its flight or hotel
+void adjustOccupancy(const Reservation *reservation, int delta) {
+    if (reservation->status != RES_PENDING && reservation->status != RES_APPROVED) {
         return;
     }
 
-    int availableRooms = calculateAvailableRooms(hotelID);
-    if (availableRooms <= 0) {
-        printf("Hotel not available or fully booked.\n");
-        return;
+    Occupancy *occupancy[2] = {NULL, NULL};
+    if (reservation->flightNumber != -1) {
+        occupancy[0] = getOccupancy(&flightOccupancy, reservation->flightNumber, true);
     }
-
-    Reservation *newReservation = (Reservation *)malloc(sizeof(Reservation));
-    if (!newReservation) {
-        perror("Failed to allocate memory for reservation");
-        return;
+    if (reservation->hotelID != -1) {
+        occupancy[1] = getOccupancy(&hotelOccupancy, reservation->hotelID, true);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (occupancy[i] == NULL) continue;
+        if (reservation->startDay == NO_DATE) {
+            occupancy[i]->undated += delta;
+        } else if (occupancyCoverDays(occupancy[i], reservation->startDay, reservation->endDay)) {
+            for (int day = reservation->startDay; day < reservation->endDay; day++) {
+                occupancy[i]->booked[day - occupancy[i]->firstDay] += delta;
+            }
+        }
     }
-
-    newReservation->reservationID = generateReservationID();
-    strcpy(newReservation->username, username);
-    newReservation->flightNumber = -1;
-    newReservation->hotelID = hotelID;
-    strcpy(newReservation->status, "Pending");
-    newReservation->next = reservationsHead;
-    reservationsHead = newReservation;
-
-    printf("Hotel reservation made successfully! Reservation ID: %d\n", newReservation->reservationID);
-    saveReservationsToFile();
 }
 
-
-void listFlightsUser() {
-    Flight *current = flightsHead;
-    if (current == NULL) {
-        printf("No flights available.\n");
-        return;
+// New submissions and status changes go to the tail; loading pushes to the head because reservationsHead is newest first
+void statusQueuePush(Reservation *reservation, bool atHead) {
+    StatusQueue *queue = &statusQueues[reservation->status];
+    if (atHead) {
+        reservation->prevInStatus = NULL;
+        reservation->nextInStatus = queue->head;
+        if (queue->head != NULL) queue->head->prevInStatus = reservation;
+        else queue->tail = reservation;
+        queue->head = reservation;
+    } else {
+        reservation->nextInStatus = NULL;
+        reservation->prevInStatus = queue->tail;
+        if (queue->tail != NULL) queue->tail->nextInStatus = reservation;
+        else queue->head = reservation;
+        queue->tail = reservation;
     }
-    while (current != NULL) {
-        int pendingReservations = countReservationsByFlight(current->flightNumber, "Pending");
-        int approvedReservations = countReservationsByFlight(current->flightNumber, "Approved");
-        int availableSeats = current->seatsAvailable - (pendingReservations + approvedReservations);
+    queue->count++;
+}
+
+void statusQueueRemove(Reservation *reservation) {
+    StatusQueue *queue = &statusQueues[reservation->status];
+    if (reservation->prevInStatus != NULL) reservation->prevInStatus->nextInStatus = reservation->nextInStatus;
+    else queue->head = reservation->nextInStatus;
+    if (reservation->nextInStatus != NULL) reservation->nextInStatus->prevInStatus = reservation->prevInStatus;
+    else queue->tail = reservation->prevInStatus;
+    reservation->prevInStatus = NULL;
+    reservation->nextInStatus = NULL;
+    queue->count--;
+}
 
-        if (availableSeats < 0) availableSeats = 0;  // Ensure we don't display negative numbers
+bool canChangeStatus(const Reservation *reservation, ReservationStatus status) {
+    return reservation->status < RES_COUNT && statusTransitions[reservation->status][status];
+}
 
-        printf("Flight %d: %s to %s, Departure: %s, Arrival: %s, Seats Available: %d\n",
-               current->flightNumber, current->origin, current->destination,
-               current->departureTime, current->arrivalTime, availableSeats);
-        current = current->next;
+// Every status change must go through here so the counters stay in sync; refuses moves not in statusTransitions
+bool setReservationStatus(Reservation *reservation, ReservationStatus status) {
+    if (!canChangeStatus(reservation, status)) {
+        return false;
     }
+    adjustOccupancy(reservation, -1);
+    statusQueueRemove(reservation);
+    reservation->status = (unsigned char)status;
+    statusQueuePush(reservation, false);
+    adjustOccupancy(reservation, 1);
+    return true;
 }
 
-int countReservationsByFlight(int flightNumber, const char* status) {
-    int count = 0;
-    Reservation *current = reservationsHead;
-    while (current != NULL) {
-        if (current->flightNumber == flightNumber && strcmp(current->status, status) == 0) {
-            count++;
+// Accepts the old spellings found in legacy files; returns -1 for an unknown name
+int parseReservationStatus(const char *name) {
+    for (int i = 0; i < RES_COUNT; i++) {
+        if (strcmp(name, statusNames[i]) == 0) {
+            return i;
         }
-        current = current->next;
     }
-    return count;
+    if (strcmp(name, "Accepted") == 0) return RES_APPROVED;
+    if (strcmp(name, "Canceled") == 0) return RES_CANCELLED;
+    return -1;
 }
-void listHotelsUser() {
-    Hotel *current = hotelsHead;
-    if (current == NULL) {
-        printf("No hotels available.\n");
-        return;
-    }
-    while (current != NULL) {
-        int pendingReservations = countReservationsByHotel(current->hotelID, "Pending");
-        int approvedReservations = countReservationsByHotel(current->hotelID, "Approved");
-        int availableRooms = current->roomsAvailable - (pendingReservations + approvedReservations);
 
-        if (availableRooms < 0) availableRooms = 0;  // Prevent negative numbers
+////////////////////////////////////////////////////////// COLUMNAR RESERVATION STORE //////////////////////////////////////////////////////////////
 
-        printf("Hotel ID %d: %s, Location: %s, Rooms Available: %d\n",
-               current->hotelID, current->name, current->location, availableRooms);
-        current = current->next;
+typedef size_t (*CountKernel)(const int *keys, const unsigned char *statuses, size_t n, int key, unsigned char status);
+typedef size_t (*FilterKernel)(const int *keys, size_t n, int key, int *rows);
+
+// Rows where keys[i] == key and statuses[i] == status
+static size_t countMatchesScalar(const int *keys, const unsigned char *statuses, size_t n, int key, unsigned char status) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += (keys[i] == key) & (statuses[i] == status);
     }
+    return count;
 }
-int countReservationsByHotel(int hotelID, const char* status) {
-    int count = 0;
-    Reservation *current = reservationsHead;
-    while (current != NULL) {
-        if (current->hotelID == hotelID && strcmp(current->status, status) == 0) {
-            count++;
+
+// Writes the row numbers where keys[i] == key into rows, returns how many
+static size_t filterMatchesScalar(const int *keys, size_t n, int key, int *rows) {
+    size_t found = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (keys[i] == key) {
+            rows[found++] = (int)i;
         }
-        current = current->next;
     }
-    return count;
+    return found;
 }
 
-//USER VE AS PROPRIAS RESERVAS (RECEBE USER COMO PARAMETRO)
-void viewUserReservations(const char *username) {
-    Reservation *current = reservationsHead;
-    bool found = false;
-    printf("Reservations for %s:\n", username);
-    while (current != NULL) {
-        if (strcmp(current->username, username) == 0) {
-            printf("Reservation ID: %d, Flight: %d, Hotel: %d, Status: %s\n",
-                   current->reservationID, current->flightNumber, current->hotelID, current->status);
-            found = true;
+#ifdef HAVE_X86_SIMD
+__attribute__((target("sse2")))
+static size_t countMatchesSSE2(const int *keys, const unsigned char *statuses, size_t n, int key, unsigned char status) {
+    const __m128i keyVec = _mm_set1_epi32(key);
+    const __m128i statusVec = _mm_set1_epi8((char)status);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int packed;
+        memcpy(&packed, statuses + i, sizeof(packed));
+        // Byte compare, then widen each 0x00/0xFF byte to a 32-bit lane mask
+        __m128i statusMask = _mm_cmpeq_epi8(_mm_cvtsi32_si128(packed), statusVec);
+        statusMask = _mm_unpacklo_epi8(statusMask, statusMask);
+        statusMask = _mm_unpacklo_epi16(statusMask, statusMask);
+        __m128i keyMask = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(keys + i)), keyVec);
+        acc = _mm_sub_epi32(acc, _mm_and_si128(keyMask, statusMask)); // Matching lanes are -1
+    }
+    unsigned int lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, acc);
+    size_t count = (size_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return count + countMatchesScalar(keys + i, statuses + i, n - i, key, status);
+}
+
+__attribute__((target("sse2")))
+static size_t filterMatchesSSE2(const int *keys, size_t n, int key, int *rows) {
+    const __m128i keyVec = _mm_set1_epi32(key);
+    size_t found = 0, i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i match = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(keys + i)), keyVec);
+        unsigned int mask = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(match));
+        while (mask) {
+            rows[found++] = (int)i + __builtin_ctz(mask);
+            mask &= mask - 1;
         }
-        current = current->next;
     }
-    if (!found) {
-        printf("No reservations found for this user.\n");
+    for (; i < n; i++) {
+        if (keys[i] == key) rows[found++] = (int)i;
     }
+    return found;
 }
 
-// USER PEDIR CANCELAMENTOS
-void cancelUserReservation(const char *username) {
-    int resID;
-    printf("Enter reservation ID to cancel or '0' to exit: ");
-    scanf("%d", &resID);
-    clearInputBuffer();
-
-    if (resID == 0) {
-        printf("Exiting...\n");
-        return; // Exits if user types '0'
+__attribute__((target("avx2")))
+static size_t countMatchesAVX2(const int *keys, const unsigned char *statuses, size_t n, int key, unsigned char status) {
+    const __m256i keyVec = _mm256_set1_epi32(key);
+    const __m128i statusVec = _mm_set1_epi8((char)status);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i statusBytes = _mm_loadl_epi64((const __m128i *)(statuses + i));
+        __m256i statusMask = _mm256_cvtepi8_epi32(_mm_cmpeq_epi8(statusBytes, statusVec));
+        __m256i keyMask = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(keys + i)), keyVec);
+        acc = _mm256_sub_epi32(acc, _mm256_and_si256(keyMask, statusMask));
     }
+    unsigned int lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, acc);
+    size_t count = 0;
+    for (int lane = 0; lane < 8; lane++) {
+        count += lanes[lane];
+    }
+    return count + countMatchesScalar(keys + i, statuses + i, n - i, key, status);
+}
 
-    Reservation *current = reservationsHead;
-    while (current != NULL) {
-        if (current->reservationID == resID && strcmp(current->username, username) == 0) {
-            if (strcmp(current->status, "Approved") == 0) {
-                strcpy(current->status, "Cancel Requested");
-                printf("Cancellation request submitted.\n");
-                saveReservationsToFile();
-                return;
-            } else {
-                printf("Only approved reservations can be cancelled.\n");
-                return;
-            }
+__attribute__((target("avx2")))
+static size_t filterMatchesAVX2(const int *keys, size_t n, int key, int *rows) {
+    const __m256i keyVec = _mm256_set1_epi32(key);
+    size_t found = 0, i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i match = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)(keys + i)), keyVec);
+        unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(match));
+        while (mask) {
+            rows[found++] = (int)i + __builtin_ctz(mask);
+            mask &= mask - 1;
         }
-        current = current->next;
     }
-    printf("Reservation not found.\n");
+    for (; i < n; i++) {
+        if (keys[i] == key) rows[found++] = (int)i;
+    }
+    return found;
 }
+#endif
 
-// ADMIN ACEITAR RESERVAS
-void handleReservationApproval() {
-    int resID;
-    char decision[10];
-    printf("Enter reservation ID to approve or reject, or '0' to exit: ");
-    scanf("%d", &resID);
-    clearInputBuffer();
+static CountKernel countKernel = NULL;
+static FilterKernel filterKernel = NULL;
+static const char *columnKernelName = "scalar";
 
-    if (resID == 0) {
-        printf("Exiting...\n");
-        return; // Exits if user types '0'
+// Picks the widest kernels this CPU supports, once
+static void selectColumnKernels() {
+    if (countKernel != NULL) {
+        return;
+    }
+    countKernel = countMatchesScalar;
+    filterKernel = filterMatchesScalar;
+#ifdef HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        countKernel = countMatchesAVX2;
+        filterKernel = filterMatchesAVX2;
+        columnKernelName = "AVX2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        countKernel = countMatchesSSE2;
+        filterKernel = filterMatchesSSE2;
+        columnKernelName = "SSE2";
     }
+#endif
+}
 
-    Reservation *current = reservationsHead;
-    while (current != NULL && current->reservationID != resID) {
-        current = current->next;
+static bool reservationColumnsGrow(ReservationColumns *columns) {
+    size_t capacity = columns->capacity ? columns->capacity * 2 : 1024;
+    int *ids = (int *)realloc(columns->reservationIDs, capacity * sizeof(int));
+    if (ids) columns->reservationIDs = ids;
+    int *flights = (int *)realloc(columns->flightNumbers, capacity * sizeof(int));
+    if (flights) columns->flightNumbers = flights;
+    int *hotels = (int *)realloc(columns->hotelIDs, capacity * sizeof(int));
+    if (hotels) columns->hotelIDs = hotels;
+    unsigned char *statuses = (unsigned char *)realloc(columns->statuses, capacity);
+    if (statuses) columns->statuses = statuses;
+    int *users = (int *)realloc(columns->users, capacity * sizeof(int));
+    if (users) columns->users = users;
+
+    if (!ids || !flights || !hotels || !statuses || !users) {
+        perror("Failed to allocate memory for reservation columns");
+        return false;
     }
-    if (current == NULL) {
-        printf("Reservation not found.\n");
-        return;
+    columns->capacity = capacity;
+    return true;
+}
+
+bool reservationColumnsAppend(ReservationColumns *columns, const Reservation *reservation) {
+    if (columns->count == columns->capacity && !reservationColumnsGrow(columns)) {
+        return false;
     }
+    size_t row = columns->count++;
+    columns->reservationIDs[row] = reservation->reservationID;
+    columns->flightNumbers[row] = reservation->flightNumber;
+    columns->hotelIDs[row] = reservation->hotelID;
+    columns->statuses[row] = reservation->status;
+    columns->users[row] = (int)reservation->user;
+    return true;
+}
 
-    printf("Approve (yes) or Reject (no)? ");
-    scanf("%s", decision);
-    clearInputBuffer();
+// Rows keep the order of the list
+bool reservationColumnsBuild(ReservationColumns *columns, const Reservation *list) {
+    for (const Reservation *current = list; current != NULL; current = current->next) {
+        if (!reservationColumnsAppend(columns, current)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    if (strcmp(decision, "yes") == 0) {
-        strcpy(current->status, "Approved");
-        printf("Reservation approved.\n");
-    } else if (strcmp(decision, "no") == 0) {
-        strcpy(current->status, "Rejected");
-        printf("Reservation rejected.\n");
-    } else {
-        printf("Invalid input.\n");
+void reservationColumnsFree(ReservationColumns *columns) {
+    free(columns->reservationIDs);
+    free(columns->flightNumbers);
+    free(columns->hotelIDs);
+    free(columns->statuses);
+    free(columns->users);
+    memset(columns, 0, sizeof(*columns));
+}
+
+size_t reservationColumnsCountFlight(const ReservationColumns *columns, int flightNumber, ReservationStatus status) {
+    selectColumnKernels();
+    return countKernel(columns->flightNumbers, columns->statuses, columns->count, flightNumber, (unsigned char)status);
+}
+
+size_t reservationColumnsCountHotel(const ReservationColumns *columns, int hotelID, ReservationStatus status) {
+    selectColumnKernels();
+    return countKernel(columns->hotelIDs, columns->statuses, columns->count, hotelID, (unsigned char)status);
+}
+
+// rows must have room for columns->count entries
+size_t reservationColumnsFilterUser(const ReservationColumns *columns, const char *username, int *rows) {
+    Symbol user = findSymbol(username);
+    if (user == 0) {
+        return 0;
     }
-    saveReservationsToFile();
+    selectColumnKernels();
+    return filterKernel(columns->users, columns->count, (int)user, rows);
 }
 
-// ADMIN ACEITAR OU NAO CANCELAMENTOS
-void handleCancellationRequests() {
-    int resID;
-    char decision[10];
+static double elapsedMs(clock_t start) {
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
 
-    printf("Enter reservation ID to process cancellation or '0' to exit: ");
-    scanf("%d", &resID);
+// DEBUG: compares the linked list with the columnar store on a synthetic data set (does not touch the real reservations)
+void benchmarkReservationStores() {
+    long long requested;
+    printf("Number of reservations to generate (0 for 10000000): ");
+    if (scanf("%lld", &requested) != 1 || requested < 0) {
+        requested = 0;
+    }
     clearInputBuffer();
-
-    if (resID == 0) {
-        printf("Exiting...\n");
-        return;
+    size_t n = requested > 0 ? (size_t)requested : 10000000;
+    enum { USER_COUNT = 1024 };
+    const int repeats = 5;
+
+    // Interned for good like any name, so a fixed set reused by every run instead of one per generated user
+    Symbol users[USER_COUNT];
+    for (int i = 0; i < USER_COUNT; i++) {
+        char username[20];
+        snprintf(username, sizeof(username), "user%d", i);
+        users[i] = internString(username);
     }
 
-    Reservation *current = reservationsHead;
-    while (current != NULL && current->reservationID != resID) {
-        current = current->next;
+    printf("Generating %zu reservations...\n", n);
+    srand(12345);
+    Arena arena = {.recordSize = sizeof(Reservation)}; // Same layout as loaded reservations, freed in one go below
+    arenaReserve(&arena, n);
+    Reservation *list = NULL;
+    size_t generated = 0;
+    for (; generated < n; generated++) {
+        Reservation *reservation = (Reservation *)arenaAlloc(&arena);
+        if (reservation == NULL) {
+            break;
+        }
+        reservation->reservationID = (int)generated + 1;
+        reservation->user = users[rand() % USER_COUNT];
+        bool isFlight = rand() % 2 == 0;
+        reservation->flightNumber = isFlight ? 1000 + rand() % 1000 : -1;
+        reservation->hotelID = isFlight ? -1 : 1 + rand() % 1000;
+        reservation->status = (unsigned char)(rand() % RES_COUNT);
+        reservation->next = list;
+        list = reservation;
     }
 
-    if (current == NULL) {
-        printf("Reservation not found.\n");
-        return;
+    ReservationColumns columns = {0};
+    clock_t start = clock();
+    bool built = reservationColumnsBuild(&columns, list);
+    double buildMs = elapsedMs(start);
+    int *rows = (int *)malloc((columns.count ? columns.count : 1) * sizeof(int));
+
+    if (built && rows != NULL) {
+        selectColumnKernels();
+        const int flightNumber = 1500;
+        const int hotelID = 500;
+        const char *username = "user42";
+        Symbol user = findSymbol(username);
+
+        struct {
+            const char *name;
+            CountKernel count;
+            FilterKernel filter;
+        } kernels[3] = {{"scalar", countMatchesScalar, filterMatchesScalar}};
+        int kernelCount = 1;
+#ifdef HAVE_X86_SIMD
+        if (__builtin_cpu_supports("sse2")) {
+            kernels[kernelCount].name = "SSE2";
+            kernels[kernelCount].count = countMatchesSSE2;
+            kernels[kernelCount++].filter = filterMatchesSSE2;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            kernels[kernelCount].name = "AVX2";
+            kernels[kernelCount].count = countMatchesAVX2;
+            kernels[kernelCount++].filter = filterMatchesAVX2;
+        }
+#endif
+
+        printf("\nBenchmark over %zu reservations, best of %d runs (runtime kernel: %s)\n", generated, repeats, columnKernelName);
+        printf("Columns built in %.1f ms\n", buildMs);
+
+        // Count flight + status
+        size_t expected = 0;
+        double best = -1;
+        for (int r = 0; r < repeats; r++) {
+            start = clock();
+            size_t count = 0;
+            for (const Reservation *current = list; current != NULL; current = current->next) {
+                if (current->flightNumber == flightNumber && current->status == RES_APPROVED) count++;
+            }
+            double ms = elapsedMs(start);
+            if (best < 0 || ms < best) best = ms;
+            expected = count;
+        }
+        printf("%-28s%-11s %8.2f ms (%zu matches)\n", "Count flight 1500 Approved:", "linked list", best, expected);
+        for (int k = 0; k < kernelCount; k++) {
+            size_t count = 0;
+            best = -1;
+            for (int r = 0; r < repeats; r++) {
+                start = clock();
+                count = kernels[k].count(columns.flightNumbers, columns.statuses, columns.count, flightNumber, RES_APPROVED);
+                double ms = elapsedMs(start);
+                if (best < 0 || ms < best) best = ms;
+            }
+            printf("%-28s%-11s %8.2f ms%s\n", "", kernels[k].name, best, count == expected ? "" : "  MISMATCH");
+        }
+        // The dispatched API the application calls, timed like the kernels it wraps
+        best = -1;
+        size_t dispatched = 0;
+        for (int r = 0; r < repeats; r++) {
+            start = clock();
+            dispatched = reservationColumnsCountFlight(&columns, flightNumber, RES_APPROVED);
+            double ms = elapsedMs(start);
+            if (best < 0 || ms < best) best = ms;
+        }
+        printf("%-28s%-11s %8.2f ms%s\n", "", "runtime", best, dispatched == expected ? "" : "  MISMATCH");
+
+        // Count hotel + status
+        best = -1;
+        for (int r = 0; r < repeats; r++) {
+            start = clock();
+            size_t count = 0;
+            for (const Reservation *current = list; current != NULL; current = current->next) {
+                if (current->hotelID == hotelID && current->status == RES_PENDING) count++;
+            }
+            double ms = elapsedMs(start);
+            if (best < 0 || ms < best) best = ms;
+            expected = count;
+        }
+        printf("%-28s%-11s %8.2f ms (%zu matches)\n", "Count hotel 500 Pending:", "linked list", best, expected);
+        for (int k = 0; k < kernelCount; k++) {
+            size_t count = 0;
+            best = -1;
+            for (int r = 0; r < repeats; r++) {
+                start = clock();
+                count = kernels[k].count(columns.hotelIDs, columns.statuses, columns.count, hotelID, RES_PENDING);
+                double ms = elapsedMs(start);
+                if (best < 0 || ms < best) best = ms;
+            }
+            printf("%-28s%-11s %8.2f ms%s\n", "", kernels[k].name, best, count == expected ? "" : "  MISMATCH");
+        }
+        best = -1;
+        for (int r = 0; r < repeats; r++) {
+            start = clock();
+            dispatched = reservationColumnsCountHotel(&columns, hotelID, RES_PENDING);
+            double ms = elapsedMs(start);
+            if (best < 0 || ms < best) best = ms;
+        }
+        printf("%-28s%-11s %8.2f ms%s\n", "", "runtime", best, dispatched == expected ? "" : "  MISMATCH");
+
+        // Filter by user
+        best = -1;
+        for (int r = 0; r < repeats; r++) {
+            start = clock();
+            size_t count = 0;
+            for (const Reservation *current = list; current != NULL; current = current->next) {
+                if (current->user == user) count++;
+            }
+            double ms = elapsedMs(start);
+            if (best < 0 || ms < best) best = ms;
+            expected = count;
+        }
+        printf("%-28s%-11s %8.2f ms (%zu matches)\n", "Filter user user42:", "linked list", best, expected);
+        for (int k = 0; k < kernelCount; k++) {
+            size_t count = 0;
+            best = -1;
+            for (int r = 0; r < repeats; r++) {
+                start = clock();
+                count = user == 0 ? 0 : kernels[k].filter(columns.users, columns.count, (int)user, rows);
+                double ms = elapsedMs(start);
+                if (best < 0 || ms < best) best = ms;
+            }
+            printf("%-28s%-11s %8.2f ms%s\n", "", kernels[k].name, best, count == expected ? "" : "  MISMATCH");
+        }
+        best = -1;
+        for (int r = 0; r < repeats; r++) {
+            start = clock();
+            dispatched = reservationColumnsFilterUser(&columns, username, rows);
+            double ms = elapsedMs(start);
+            if (best < 0 || ms < best) best = ms;
+        }
+        printf("%-28s%-11s %8.2f ms%s\n", "", "runtime", best, dispatched == expected ? "" : "  MISMATCH");
     }
 
-    printf("Confirm cancellation (yes/no) or type 'exit' to leave: ");
-    scanf("%9s", decision);
-    clearInputBuffer();
+    free(rows);
+    reservationColumnsFree(&columns);
+    arenaFreeAll(&arena);
+}
 
-    if (strcmp(decision, "exit") == 0) {
-        printf("Exiting without making changes.\n");
-        return; // Exits if user types 'exit'
-    }
+////////////////////////////////////////////////////////// RECORD ARENAS //////////////////////////////////////////////////////////////
 
-    if (strcmp(decision, "yes") == 0) {
-        strcpy(current->status, "Cancelled");
-        printf("Cancellation approved.\n");
-    } else if (strcmp(decision, "no") == 0) {
-        strcpy(current->status, "Approved");
-        printf("Cancellation denied.\n");
-    } else {
-        printf("Invalid input. No changes made.\n");
+static bool arenaAddSlab(Arena *arena, size_t capacity) {
+    ArenaSlab *slab = (ArenaSlab *)malloc(sizeof(ArenaSlab) + capacity * arena->recordSize);
+    if (slab == NULL) {
+        perror("Failed to allocate memory for records");
+        return false;
     }
-    saveReservationsToFile();
+    slab->used = 0;
+    slab->capacity = capacity;
+    slab->next = arena->slabs;
+    arena->slabs = slab;
+    return true;
 }
 
-//FUNÇAO DE LISTAR SEM FILTROS
-void viewAllReservations() {
-    printf("\nAll Reservations:\n");
-    if (reservationsHead == NULL) {
-        printf("No reservations available.\n");
-        return;
+// The next "records" allocations come from one slab, contiguous; loaders call it with the record count of the file
+bool arenaReserve(Arena *arena, size_t records) {
+    ArenaSlab *slab = arena->slabs;
+    if (records == 0 || (slab != NULL && slab->capacity - slab->used >= records)) {
+        return true;
     }
+    // Exactly what the load needs (never below ARENA_FIRST_SLAB), so a 5-user file does not get a 65536-record slab
+    return arenaAddSlab(arena, records > ARENA_FIRST_SLAB ? records : ARENA_FIRST_SLAB);
+}
 
-    Reservation *current = reservationsHead;
-    while (current != NULL) {
-        printf("Reservation ID: %d, User: %s, ", current->reservationID, current->username);
-        if (current->flightNumber != -1) {
-            printf("Flight Number: %d, ", current->flightNumber);
+void *arenaAlloc(Arena *arena) {
+    ArenaSlab *slab = arena->slabs;
+    if (slab == NULL || slab->used == slab->capacity) {
+        // Slabs double from ARENA_FIRST_SLAB so a small catalog stays small and a big load makes few mallocs
+        size_t capacity = slab == NULL ? ARENA_FIRST_SLAB : slab->capacity * 2;
+        if (capacity > ARENA_MAX_SLAB) capacity = ARENA_MAX_SLAB;
+        if (!arenaAddSlab(arena, capacity)) {
+            return NULL;
         }
-        if (current->hotelID != -1) {
-            printf("Hotel ID: %d, ", current->hotelID);
-        }
-        printf("Status: %s\n", current->status);
-        current = current->next;
+        slab = arena->slabs;
     }
+    return slab->records + slab->used++ * arena->recordSize;
 }
 
-//FUNÇAO DE LISTAR MAE QUE COMPARA AO STATUS FORNECIDO
-void listReservationsByStatus(const char *status) {
-    Reservation *current = reservationsHead;
-    int found = 0;
-    printf("\nReservations with status '%s':\n", status);
-    while (current != NULL) {
-        if (strcmp(current->status, status) == 0) {
-            printf("Reservation ID: %d, User: %s, Flight Number: %d, Hotel ID: %d\n",
-                   current->reservationID, current->username,
-                   current->flightNumber, current->hotelID);
-            found = 1;
-        }
-        current = current->next;
+// Gives back the record of the last arenaAlloc (a read that failed after allocating)
+void arenaUnalloc(Arena *arena) {
+    if (arena->slabs != NULL && arena->slabs->used > 0) {
+        arena->slabs->used--;
     }
-    if (!found) {
-        printf("No reservations found with status '%s'.\n", status);
+}
+
+// Frees the whole generation at once; every pointer into the arena is dead afterwards
+void arenaFreeAll(Arena *arena) {
+    while (arena->slabs != NULL) {
+        ArenaSlab *next = arena->slabs->next;
+        free(arena->slabs);
+        arena->slabs = next;
     }
 }
-//LISTAR PENDING
-void viewPendingReservations() {
-    listReservationsByStatus("Pending");
+
+// Exit only: lists and the id/name indexes are emptied, then every record goes with one free per slab. The route and
+// departure buckets, statusQueues, userReservationsIndex, the city trie and the occupancy tables still point into the
+// freed arenas (or are left allocated), so nothing may run after it except exit
+void freeAllRecords() {
+    intIndexClear(&flightIndex);
+    intIndexClear(&hotelIndex);
+    intIndexClear(&reservationIndex);
+    strIndexClear(&userIndex);
+    head = NULL;
+    usersTail = NULL;
+    free(userSlots.slots);
+    userSlots.slots = NULL;
+    userSlots.capacity = 0;
+    flightsHead = NULL;
+    hotelsHead = NULL;
+    reservationsHead = NULL;
+    reservationPool.freeList = NULL;
+    reservationPool.freeCount = 0;
+    arenaFreeAll(&userArena);
+    arenaFreeAll(&flightArena);
+    arenaFreeAll(&hotelArena);
+    arenaFreeAll(&reservationArena);
 }
-//LISTAR PEDIDOS DE CANCELAMENTO
-void viewRequestCanceledReservations() {
-    listReservationsByStatus("Cancel Requested");
+
+// Booking path: a released node is handed out again before the arena is touched
+Reservation *reservationPoolAcquire(ReservationPool *pool) {
+    Reservation *reservation = pool->freeList;
+    if (reservation != NULL) {
+        pool->freeList = reservation->next;
+        pool->freeCount--;
+        pool->hits++;
+        return reservation;
+    }
+    pool->misses++;
+    return (Reservation *)arenaAlloc(pool->arena);
 }
-//LISTAR ACEITES
-void viewAcceptedReservations() {
-    listReservationsByStatus("Accepted");
-} // se necessario
 
-//LISTAR CANCELADOS
-void viewCanceledReservations() {
-    listReservationsByStatus("Canceled");
-} // se necessario
+// The node must already be out of every list and index; its next field becomes the free list link
+void reservationPoolRelease(ReservationPool *pool, Reservation *reservation) {
+    reservation->next = pool->freeList;
+    pool->freeList = reservation;
+    pool->freeCount++;
+    pool->releases++;
+}
 
-//LISTAR REJEITADOS
-void viewrRejectedReservations() {
-    listReservationsByStatus("Rejected");
-} // se necessario
-////////////////////////////////////////////////////////// NO OVERBOOKING //////////////////////////////////////////////////////////////
+void printReservationPoolStats(const char *label, const ReservationPool *pool) {
+    size_t requests = pool->hits + pool->misses;
+    printf("%s: %zu acquired (%zu from the free list, %zu from the arena, %.1f%% hit rate), %zu released, %zu free\n",
+           label, requests, pool->hits, pool->misses, requests ? 100.0 * pool->hits / requests : 0.0,
+           pool->releases, pool->freeCount);
+}
 
-int calculateAvailableSeats(int flightNumber) {
-    int approved = countReservationsByFlight(flightNumber, "Approved");
-    Flight *flight = flightsHead;
-    while (flight && flight->flightNumber != flightNumber) {
-        flight = flight->next;
+// Create/cancel churn with a fixed number of live reservations, malloc/free against the pool
+void benchmarkReservationPool() {
+    const size_t operations = 5000000;
+    enum { LIVE = 1024 };
+    Reservation *live[LIVE] = {0};
+
+    clock_t start = clock();
+    for (size_t i = 0; i < operations; i++) {
+        free(live[i % LIVE]);
+        live[i % LIVE] = (Reservation *)malloc(sizeof(Reservation));
+        if (live[i % LIVE] == NULL) {
+            perror("Failed to allocate memory for benchmark");
+            break;
+        }
+        live[i % LIVE]->reservationID = (int)i;
+    }
+    double mallocMs = elapsedMs(start);
+    for (int i = 0; i < LIVE; i++) {
+        free(live[i]);
+        live[i] = NULL;
     }
-    return (flight ? flight->seatsAvailable - approved : 0);
-}
 
-// Helper function to calculate available rooms for hotels
-int calculateAvailableRooms(int hotelID) {
-    int approved = countReservationsByHotel(hotelID, "Approved");
-    Hotel *hotel = hotelsHead;
-    while (hotel && hotel->hotelID != hotelID) {
-        hotel = hotel->next;
+    Arena arena = {.recordSize = sizeof(Reservation)};
+    ReservationPool pool = {.arena = &arena};
+    start = clock();
+    for (size_t i = 0; i < operations; i++) {
+        if (live[i % LIVE] != NULL) {
+            reservationPoolRelease(&pool, live[i % LIVE]);
+        }
+        live[i % LIVE] = reservationPoolAcquire(&pool);
+        if (live[i % LIVE] == NULL) {
+            break;
+        }
+        live[i % LIVE]->reservationID = (int)i;
     }
-    return (hotel ? hotel->roomsAvailable - approved : 0);
+    double poolMs = elapsedMs(start);
+
+    printf("%zu create/cancel operations, %d live reservations:\n", operations, LIVE);
+    printf("%-14s %8.2f ms\n", "malloc/free:", mallocMs);
+    printf("%-14s %8.2f ms\n", "pool:", poolMs);
+    printReservationPoolStats("Benchmark pool", &pool);
+    printReservationPoolStats("Session pool", &reservationPool);
+    arenaFreeAll(&arena);
 }
 
 ////////////////////////////////////////////////////////// GERAR IDS //////////////////////////////////////////////////////////////
 
+static int lastReservationID = 0;  // Last ID handed out, 0 until last_id.txt has been read
+
 int generateReservationID() {
-    static int lastID = 0;  // Static variable to keep track of the last ID
-    if (lastID == 0) {
-        lastID = loadLastReservationID();  // Load the last ID when the function is called for the first time
+    if (lastReservationID == 0) {
+        lastReservationID = loadLastReservationID();  // Load the last ID when the function is called for the first time
+    }
+    return ++lastReservationID;  // Increment and return the new ID
+}
+
+// Loading: an ID found in reservations.dat or the log was handed out, even if last_id.txt was not saved before a crash
+void advanceReservationID(int reservationID) {
+    if (lastReservationID == 0) {
+        lastReservationID = loadLastReservationID();
+    }
+    if (reservationID > lastReservationID) {
+        lastReservationID = reservationID;
     }
-    return ++lastID;  // Increment and return the new ID
 }
 
 ////////////////////////////////////////////////////////// DEBUG //////////////////////////////////////////////////////////////
@@ -1495,7 +5382,7 @@ void manageFlights() - Menu para adicionar, remover, editar e listar voos
 
 void listUsersWithID() - Lista todos os users para saber quais apagar com um respetivo id
 
-void deleteUser() - Apagar users
+void deleteUser() - Apagar users pelo id fixo (tabela userSlots, sem percorrer a lista; o id nao volta a ser usado)
 
 void addHotel() - Adicionar hotel
 
@@ -1517,6 +5404,46 @@ void editFlight() - Editar voos
 
 void listFlights() - Listar voos
 
+void searchFlights() - Pesquisa de voos do user por origem e/ou destino (vazio = qualquer)
+
+const FlightBucket *findFlightsOnRoute(const char *origin, const char *destination) - Devolve os voos da rota usando os indices routeIndex/originIndex/destinationIndex
+
+void routeIndexAdd(Flight *flight) - Mete o voo nos indices de rotas (chamar ao adicionar, carregar e depois de editar)
+
+void routeIndexRemove(Flight *flight) - Tira o voo dos indices de rotas (chamar ao apagar e antes de editar)
+
+int findFlightsByDeparture(const char *origin, const char *destination, int fromMinutes, int toMinutes, Flight ***first) - Voos que partem numa janela de horas, pesquisa binaria nos indices ordenados por hora de partida
+
+int parseTimeOfDay(const char *text) - Converte "7:00"/"07:00" para minutos desde a meia-noite (-1 se invalido)
+
+void parseFlightTimes(Flight *flight) - Preenche departureMinutes/arrivalMinutes a partir das strings (chamar ao carregar, adicionar e editar)
+
+void printFlightAvailability(const Flight *flight) - Imprime o voo com os lugares livres (usado no listar do user e na pesquisa)
+
+void searchHotels() - Pesquisa de hoteis do user por palavras do nome ou da localizaçao
+
+int *findHotelsByKeywords(const char *query, int *count) - Devolve os ids dos hoteis com todas as palavras (indice invertido hotelTokenIndex), o array tem de ser libertado
+
+void hotelTokenIndexAdd(const Hotel *hotel) - Mete as palavras do nome e localizaçao no indice (chamar ao adicionar, carregar e depois de editar)
+
+void hotelTokenIndexRemove(const Hotel *hotel) - Tira o hotel do indice (chamar ao apagar e antes de editar)
+
+void printHotelAvailability(const Hotel *hotel) - Imprime o hotel com os quartos livres (usado no listar do user e na pesquisa)
+
+void buildFlightGraph() - Constroi o grafo de voos (aeroportos = nos, voos = arestas) para a pesquisa de escalas, feito ao carregar e quando o catalogo muda
+
+int findConnections(const char *origin, const char *destination, int maxLegs, int minConnection, int startMinutes, Itinerary *results) - Itinerarios com escalas que chegam mais cedo (ate maxLegs voos, minConnection minutos entre voos)
+
+size_t foldText(const char *text, char *out, size_t size) - Passa o texto para minusculas e tira os acentos (UTF-8, "São Paulo" -> "sao paulo"), usado em todas as chaves de cidades e palavras
+
+int fuzzySearchNames(const char *query, FuzzyKind kind, FuzzyMatch *results, int maxResults) - Cidades ou hoteis com o nome mais parecido (trigramas em comum), para erros de escrita
+
+int autocompleteCity(const char *prefix, const char **results, int maxResults) - Devolve as cidades mais usadas que começam pelo prefixo (trie comprimida com top-k em cada no)
+
+void buildCityTrie() - Constroi a trie das cidades a partir dos voos e hoteis (feito sozinho quando o catalogo muda)
+
+void freeCityTrie() - Liberta a trie das cidades
+
 void registerUser() - Criar utilizador ( username / password / 0 - user & 1 - admin )
 
 int loginUser(int expectedAdmin) - login
@@ -1536,6 +5463,7 @@ void saveHotelsToFile() - load do ficheiro hotels.txt (texto)
 void loadHotelsFromFile() - save para o ficheiro hotels.txt (texto)
 
 void saveReservationsToFile() - load do ficheiro reservations.dat (binario)         // INFORMAÇAO SENSIVEL POR ISSO FICOU EM BINARIO
+    Agora é o checkpoint: grava todas as reservas e apaga os segmentos do log que ja ficaram no ficheiro (corre sozinho quando o segmento passa CHECKPOINT_LOG_BYTES)
 
 void loadReservationsFromFile() - save para o ficheiro reservations.dat (binario)
 
@@ -1555,12 +5483,8 @@ void makeHotelReservation(const char *username) - faz a reserva
 
 void listFlightsUser() - Lista os voos ao fazer reserva
 
-int countReservationsByFlight(int flightNumber, const char* status) - Faz a conta de quantas reservas ja ha, para mostrar um numero correto de lugares no listar acima
-
 void listHotelsUser() - Lista os hoteis ao fazer reserva
 
-int countReservationsByHotel(int hotelID, const char* status) - Faz a conta de quantas reservas ja ha, para mostrar um numero correto de lugares no listar acima
-
 void viewUserReservations(const char *username) - User lista as SUAS reservas
 
 void cancelUserReservation(const char *username) - Pedido pelo user para cancelar uma reserva de estado aproved
@@ -1571,7 +5495,7 @@ void handleCancellationRequests() - Handling do admin para recusar ou aceitar ca
 
 void viewAllReservations() - Listar todas as reservas
 
-void listReservationsByStatus(const char *status) - Chamado pelos filtros abaixo
+void listReservationsByStatus(ReservationStatus status) - Chamado pelos filtros abaixo
 
 void viewPendingReservations() - Listar com filtro as reservas
 
@@ -1583,12 +5507,140 @@ void viewCanceledReservations() - Listar com filtro as reservas
 
 void viewrRejectedReservations() - Listar com filtro as reservas
 
-int calculateAvailableSeats(int flightNumber) Calcula bancos disponiveis para a funçao de fazer reserva pra ter a certeza que nao ha overbooking
+int calculateAvailableSeats(int flightNumber, int day) Calcula bancos disponiveis nesse dia para a funçao de fazer reserva pra ter a certeza que nao ha overbooking (O(1), le o array por dia)
 
-int calculateAvailableRooms(int hotelID) - Calcula quartos disponiveis para a funçao de fazer reserva pra ter a certeza que nao ha overbooking
+int calculateAvailableRooms(int hotelID, int checkIn, int checkOut) - Calcula quartos disponiveis em todas as noites da estadia (a noite mais cheia decide) pra ter a certeza que nao ha overbooking
+
+int daysFromCivil(int year, int month, int day) - Converte a data para numero de dias desde 1970-01-01 (as datas das reservas sao guardadas assim)
+
+int parseDate(const char *text) - Le uma data YYYY-MM-DD, NO_DATE se for invalida (ex: 30 de fevereiro)
+
+void formatDate(int day, char *out, size_t size) - Numero de dias de volta para YYYY-MM-DD
+
+int currentDay() - Dia de hoje (nao se pode reservar para trás)
+
+void formatReservationDates(const Reservation *reservation, char *out, size_t size) - Texto das datas da reserva para as listagens (vazio nas reservas antigas sem data)
+
+void *intIndexFind(const IntIndex *index, int key) - Procura no indice hash (open addressing) pelo id, O(1) em vez de percorrer a lista
+
+bool intIndexInsert(IntIndex *index, int key, void *value) - Insere no indice hash, cresce a tabela quando passa 3/4 de ocupaçao
+
+void intIndexRemove(IntIndex *index, int key) - Remove do indice hash (deixa tombstone no slot)
+
+void intIndexClear(IntIndex *index) - Liberta a memoria do indice
+
+Flight *findFlight(int flightNumber) - Devolve o voo pelo numero usando o flightIndex
+
+Hotel *findHotel(int hotelID) - Devolve o hotel pelo id usando o hotelIndex
+
+void *strIndexFind(const StrIndex *index, const char *key) - Igual ao intIndexFind mas com chave string (hash FNV-1a)
+
+bool strIndexInsert(StrIndex *index, const char *key, void *value) - Insere no indice de strings, a chave aponta para o proprio registo
+
+void strIndexRemove(StrIndex *index, const char *key) - Remove do indice de strings
+
+void strIndexClear(StrIndex *index) - Liberta a memoria do indice de strings
+
+User *findUser(const char *username) - Devolve o user pelo username usando o userIndex (login e registo)
+
+User *findUserByID(int userID) - Devolve o user pelo id fixo (tabela userSlots), usado no apagar user do admin
+
+bool assignUserSlot(User *user) - Da o proximo id ao user novo (ou regista o id lido do users.dat) na tabela userSlots
+
+Reservation *findReservation(int reservationID) - Devolve a reserva pelo id usando o reservationIndex (aprovaçoes e cancelamentos)
+
+UserReservations *getUserReservations(Symbol user, bool create) - Lista das reservas de um user (cria se create for true)
+
+int purgeClosedReservations() - No load, tira do historico as reservas rejeitadas/canceladas com mais de 90 dias e devolve os nos ao pool (reutilizados nas reservas seguintes)
+
+void linkUserReservation(Reservation *reservation, bool atHead) - Junta a reserva a lista do user, chamado ao criar e ao carregar reservas
+
+Symbol internString(const char *text) - Guarda cada nome (username, cidade) uma so vez e devolve o id de 32 bits; comparar nomes passa a ser comparar ints
+
+Symbol findSymbol(const char *text) - Id de um nome ja guardado, 0 se nunca apareceu (nao guarda)
+
+const char *symbolName(Symbol symbol) - Texto de um id (para imprimir e gravar nos ficheiros)
+
+Occupancy *getOccupancy(IntIndex *index, int key, bool create) - Contadores de reservas Pending/Approved de um voo ou hotel
+
+void adjustOccupancy(const Reservation *reservation, int delta) - Soma ou tira a reserva dos contadores do voo/hotel (e dos dias que ela ocupa)
+
+int bookedOnDay(const Occupancy *occupancy, int day) - Reservas com data que ocupam esse dia
+
+void statusQueuePush(Reservation *reservation, bool atHead) - Mete a reserva na fila do seu estado (as notificaçoes do admin so percorrem estas filas)
+
+void statusQueueRemove(Reservation *reservation) - Tira a reserva da fila do seu estado
+
+bool canChangeStatus(const Reservation *reservation, ReservationStatus status) - Verifica na statusTransitions se a mudança de estado é permitida
+
+bool setReservationStatus(Reservation *reservation, ReservationStatus status) - Muda o estado da reserva e atualiza os contadores (usar sempre esta), false se a transiçao nao é permitida
+
+int parseReservationStatus(const char *name) - Converte o texto do estado antigo (inclui "Accepted"/"Canceled") para o enum, usado na migraçao do reservations.dat
+
+bool reservationColumnsBuild(ReservationColumns *columns, const Reservation *list) - Copia a lista de reservas para o formato em colunas (um array por campo)
+
+bool reservationColumnsAppend(ReservationColumns *columns, const Reservation *reservation) - Junta uma reserva as colunas
+
+void reservationColumnsFree(ReservationColumns *columns) - Liberta as colunas
+
+size_t reservationColumnsCountFlight/CountHotel(...) - Conta reservas de um voo/hotel com um estado, usa kernels SSE2/AVX2 escolhidos em runtime (ou scalar)
+
+size_t reservationColumnsFilterUser(const ReservationColumns *columns, const char *username, int *rows) - Devolve as linhas das reservas de um user
+
+void benchmarkReservationStores() - Debug (opçao escondida 6 no menu inicial) para comparar a lista ligada com as colunas
+
+bool arenaReserve(Arena *arena, size_t records) - Garante que os proximos records ficam seguidos no mesmo slab (os loads chamam com o numero de registos do ficheiro)
+
+void *arenaAlloc(Arena *arena) - Da um registo (User/Flight/Hotel/Reservation) da arena em vez de um malloc por registo
+
+void arenaUnalloc(Arena *arena) - Devolve o ultimo registo dado (quando a leitura falha)
+
+void arenaFreeAll(Arena *arena) - Liberta todos os registos da arena de uma vez
+
+void freeAllRecords() - Liberta todos os registos, so ao sair do programa (os outros indices ficam a apontar para memoria libertada)
+
+bool lineReaderOpen(LineReader *reader, const char *path) - Abre um ficheiro de texto para ler linha a linha em blocos de 1 MB
+
+char *lineReaderNext(LineReader *reader, size_t *length) - Proxima linha (encontrada com memchr, sem o \n nem \r), NULL no fim do ficheiro
+
+void lineReaderClose(LineReader *reader) - Fecha o ficheiro e liberta o buffer
+
+int splitFields(char *line, size_t length, char **fields, int maxFields) - Parte a linha nos '|' (memchr), devolve o numero de campos
+
+bool parseIntField(const char *text, int *value) - Le um campo numerico, false se tiver lixo ou nao couber num int
+
+bool mapFile(const char *path, MappedFile *file) - Mapeia o ficheiro binario todo em memoria so de leitura (mmap, MapViewOfFile no Windows, ou um so fread noutros sistemas)
+
+const void *mappedNext(MappedFile *file, size_t size) - Devolve o proximo registo diretamente da memoria mapeada, sem copiar para um buffer
+
+void unmapFile(MappedFile *file) - Desfaz o mapeamento (antes de renomear/regravar o ficheiro)
+
+Reservation *reservationPoolAcquire(ReservationPool *pool) - Da um no de reserva, primeiro da free list e so depois da arena (usado ao fazer reservas)
+
+void reservationPoolRelease(ReservationPool *pool, Reservation *reservation) - Devolve o no a free list para ser reutilizado
+
+void printReservationPoolStats(const char *label, const ReservationPool *pool) - Mostra hits/misses do pool
+
+void benchmarkReservationPool() - Debug (opçao escondida 7 no menu inicial) compara malloc/free com o pool num ciclo de criar/cancelar
 
 int generateReservationID() - Gera o id da reserva, começam apartir de 1000
 
+void advanceReservationID(int reservationID) - No load, garante que o proximo id fica acima das reservas lidas do ficheiro e do log (mesmo sem last_id.txt atualizado)
+
+void addReservation(Reservation *reservation) - Junta a reserva nova a lista e a todos os indices/contadores (fazer reserva e replay do log)
+
+uint32_t computeCrc32(uint32_t crc, const void *data, size_t length) - CRC-32 para detetar registos estragados nos ficheiros binarios (passar o resultado anterior em crc para continuar)
+
+void logReservationCreated(const Reservation *reservation) - Escreve so a reserva nova no fim do segmento atual do log (reservations.log.N, 80 bytes) em vez de regravar o reservations.dat todo
+
+void logReservationStatus(const Reservation *reservation) - Escreve a mudança de estado no fim do segmento atual do log
+
+bool replayReservationLog() - No load, aplica os segmentos do log que o reservations.dat ainda nao tem; para no primeiro registo com checksum errado
+
+void setAsideReservationLog() - Quando o reservations.dat e rejeitado, muda os segmentos do log para .bad e recomeça no segmento 1
+
+void closeReservationLog() - Fecha o segmento atual do log (ao sair e no checkpoint)
+
 void clearInputBuffer() - parecido ao fflush(stdin) mas melhor porque o comportamento nao varia consoante ambiente em que é utilizado
 
 void printAllUsersInMemory() - Debug pra ver users em memoria quando criados (no inicio nao estava a gravar corretamente)